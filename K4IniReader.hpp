@@ -34,133 +34,3379 @@
 
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <fstream>
-#include <cctype>
 #include <algorithm>
 #include <charconv>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <array>
+#include <limits>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#if ((defined(_MSVC_LANG) && _MSVC_LANG >= 202002L) || __cplusplus >= 202002L) && __has_include(<coroutine>)
+#define K4INIREADER_COROUTINES
+#include <coroutine>
+#include <functional>
+#endif
+
+// Compressed files are decompressed while they're read if K4INIREADER_ZLIB (gzip, link with -lz)
+// or K4INIREADER_ZSTD (zstd, link with -lzstd) is defined before including this header
+#ifdef K4INIREADER_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef K4INIREADER_ZSTD
+#include <zstd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define K4INIREADER_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <cerrno>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define K4INIREADER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Options used when loading a .ini file
+struct K4IniOptions {
+    size_t nSections = 32; // Number of sections to pre-allocate
+    size_t nKeys = 8;      // Minimum number of keys to pre-allocate for each section; only used above 16 (smaller sections are sized from their keys)
+    bool lazy = false;     // If true, only the section headers are indexed at load; a section's keys are parsed on its first read
+    size_t filterBitsPerKey = 0; // If not 0, builds a Bloom filter of this many bits per key to reject missing keys quickly (not available in lazy mode)
+    std::vector<std::string> tables; // Prefixes of section names (e.g. "tenant.") whose sections share the same keys and are stored by column (not available in lazy mode)
+    size_t largeValueBytes = 0;      // If not 0, values longer than this are left in the file and only read on their first access (uncompressed files, not in lazy mode)
+    bool validateUtf8 = false;       // If true, checks that the content is valid UTF-8 (see K4IniReader::invalidUtf8Offset)
+    std::pmr::memory_resource* memoryResource = nullptr; // If set, the names, values and map nodes are allocated from it instead of the default resource (not the file content kept in lazy mode)
+};
+
+// Outcome of reading a value
+enum class K4IniStatus {
+    Ok,
+    Missing,    // The section or the key wasn't found
+    Unparsable, // The value can't be converted to the type read
+    OutOfRange  // The value is a number that doesn't fit in the type read
+};
+
+// Result of K4IniReader::readResult: the value read, or why there's none
+template<typename T>
+struct K4IniResult {
+    K4IniStatus status = K4IniStatus::Missing;
+    T value{}; // Only meaningful if status is Ok
+
+    inline explicit operator bool() const noexcept { return status == K4IniStatus::Ok; }
+    inline const T& operator*() const noexcept { return value; }
+    inline const T* operator->() const noexcept { return &value; }
+
+    inline T valueOr(T defaultValue) const { return status == K4IniStatus::Ok ? value : defaultValue; }
+};
+
+// Conversion of the values read to T (used by read, tryRead, readResult, readColumn and parse).
+// Specialize it to read other types: 'parse' gets the stored value in place (trimmed, unquoted, no copy)
+// and returns whether it could convert it (bool) or a K4IniStatus, leaving 'out' untouched if it couldn't:
+//     template<> struct K4IniConvert<Color> {
+//         static bool parse(std::string_view text, Color& out) noexcept;
+//     };
+//     Color accent = iniReader.read("Theme", "accent", Color{});
+// Numbers and booleans are converted once at load; the reader uses that result before calling 'parse'.
+template<typename T, typename Enable = void>
+struct K4IniConvert {}; // Unhandled types: reads return the default value
+
+template<>
+struct K4IniConvert<bool> {
+    // Only "true", "1", "on" and "yes" are true; anything else is read as false
+    static K4IniStatus parse(std::string_view text, bool& out) noexcept {
+        out = (text == "true" || text == "1" || text == "on" || text == "yes");
+        return K4IniStatus::Ok;
+    }
+};
+
+template<>
+struct K4IniConvert<char> {
+    // The first character of the value
+    static K4IniStatus parse(std::string_view text, char& out) noexcept {
+        if (text.empty()) return K4IniStatus::Unparsable;
+
+        out = text[0];
+        return K4IniStatus::Ok;
+    }
+};
+
+template<typename T>
+struct K4IniConvert<T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>> {
+    // The value must start with a number that fits in T;
+    // if it fails, from_chars doesn't modify the out value
+    static K4IniStatus parse(std::string_view text, T& out) noexcept {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+        if (result.ec == std::errc::result_out_of_range) return K4IniStatus::OutOfRange;
+        return result.ec == std::errc() ? K4IniStatus::Ok : K4IniStatus::Unparsable;
+    }
+};
+
+template<>
+struct K4IniConvert<std::string> {
+    static K4IniStatus parse(std::string_view text, std::string& out) {
+        out.assign(text);
+        return K4IniStatus::Ok;
+    }
+};
+
+// Lists: items separated by commas or line breaks (e.g. in a heredoc), each trimmed; empty items are skipped.
+// The list is left untouched if any item can't be converted.
+template<typename T>
+struct K4IniConvert<std::vector<T>, std::void_t<decltype(K4IniConvert<T>::parse(std::declval<std::string_view>(), std::declval<T&>()))>> {
+    static K4IniStatus parse(std::string_view text, std::vector<T>& out) {
+        std::vector<T> items;
+        items.reserve(static_cast<size_t>(std::count_if(text.begin(), text.end(), [](char c) { return c == ',' || c == '\n'; })) + 1);
+
+        size_t pos = 0;
+        while (pos <= text.size()) {
+            size_t end = text.find_first_of(",\n", pos);
+            if (end == std::string_view::npos) end = text.size();
+
+            std::string_view item = text.substr(pos, end - pos);
+            while (!item.empty() && (item.front() == ' ' || item.front() == '\t' || item.front() == '\r')) item.remove_prefix(1);
+            while (!item.empty() && (item.back() == ' ' || item.back() == '\t' || item.back() == '\r')) item.remove_suffix(1);
+
+            if (!item.empty()) {
+                T value{};
+                auto result = K4IniConvert<T>::parse(item, value);
+                if constexpr (std::is_same_v<decltype(result), bool>) {
+                    if (!result) return K4IniStatus::Unparsable;
+                }
+                else if (result != K4IniStatus::Ok) return result;
+
+                items.push_back(std::move(value));
+            }
+            pos = end + 1;
+        }
+
+        out.swap(items);
+        return K4IniStatus::Ok;
+    }
+};
+
+// IPv4 or IPv6 address
+struct K4IniAddress {
+    enum class Family : uint8_t { IPv4, IPv6 };
+
+    std::array<uint8_t, 16> bytes{}; // Network byte order; an IPv4 address only uses the first 4 bytes
+    Family family = Family::IPv4;
+
+    inline bool isIPv4() const noexcept { return family == Family::IPv4; }
+    inline size_t size() const noexcept { return isIPv4() ? 4 : 16; }
+
+    // IPv4 address in host byte order (e.g. 10.0.0.1 is 0x0A000001)
+    inline uint32_t ipv4() const noexcept {
+        return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+    }
+
+    inline bool operator==(const K4IniAddress& other) const noexcept { return family == other.family && bytes == other.bytes; }
+    inline bool operator!=(const K4IniAddress& other) const noexcept { return !(*this == other); }
+};
+
+// Network prefix in CIDR notation ("10.0.0.0/8", "fd00::/8")
+struct K4IniCidr {
+    K4IniAddress network; // Its bits past the prefix are zero
+    uint8_t prefix = 0;   // Number of leading bits of the network
+
+    // Whether an address belongs to the network
+    inline bool contains(const K4IniAddress& address) const noexcept {
+        if (address.family != network.family) return false;
+
+        size_t fullBytes = prefix / 8;
+        if (std::memcmp(address.bytes.data(), network.bytes.data(), fullBytes) != 0) return false;
+
+        unsigned restBits = prefix % 8;
+        if (restBits == 0) return true;
+
+        uint8_t mask = static_cast<uint8_t>(0xFF << (8 - restBits));
+        return (address.bytes[fullBytes] & mask) == network.bytes[fullBytes];
+    }
+};
+
+// Host and port ("10.0.0.1:8080", "[::1]:443", "db.local:5432")
+struct K4IniEndpoint {
+    K4IniAddress address; // Only meaningful if 'host' is empty
+    std::string host;     // Host name, if the host isn't an address
+    uint16_t port = 0;
+};
+
+template<>
+struct K4IniConvert<K4IniAddress> {
+    // Dotted-decimal IPv4 address; octets with leading zeros are rejected, as inet_pton does
+    static bool parseIPv4(std::string_view text, uint8_t* out) noexcept {
+        size_t i = 0;
+        for (int octet = 0; octet < 4; ++octet) {
+            if (octet != 0 && (i >= text.size() || text[i++] != '.')) return false;
+
+            size_t start = i;
+            unsigned value = 0;
+            while (i < text.size() && i - start < 4 && static_cast<unsigned>(text[i] - '0') < 10)
+                value = value * 10 + static_cast<unsigned>(text[i++] - '0');
+
+            size_t digits = i - start;
+            if (digits == 0 || digits > 3 || value > 255 || (digits > 1 && text[start] == '0')) return false;
+            out[octet] = static_cast<uint8_t>(value);
+        }
+        return i == text.size();
+    }
+
+    // IPv6 address as in RFC 4291: up to 8 hexadecimal groups, one "::" at most, optionally ending with an IPv4 address
+    static bool parseIPv6(std::string_view text, uint8_t* out) noexcept {
+        static constexpr auto hexTable = [] {
+            std::array<int8_t, 256> table{};
+            for (auto& v : table) v = -1;
+            for (int c = 0; c < 10; ++c) table['0' + c] = static_cast<int8_t>(c);
+            for (int c = 0; c < 6; ++c) table['a' + c] = table['A' + c] = static_cast<int8_t>(10 + c);
+            return table;
+        }();
+
+        uint16_t groups[8] = {};
+        int n = 0;
+        int gap = -1; // Index of the group where "::" is
+        size_t i = 0;
+
+        if (text.size() >= 2 && text[0] == ':' && text[1] == ':') { gap = 0; i = 2; }
+
+        while (i < text.size()) {
+            if (n == 8) return false;
+
+            size_t start = i;
+            unsigned value = 0;
+            for (int digit; i < text.size() && i - start < 5 && (digit = hexTable[static_cast<unsigned char>(text[i])]) >= 0; ++i)
+                value = (value << 4) | static_cast<unsigned>(digit);
+
+            if (i < text.size() && text[i] == '.') { // The last 32 bits written as an IPv4 address
+                uint8_t v4[4];
+                if (n > 6 || !parseIPv4(text.substr(start), v4)) return false;
+
+                groups[n++] = static_cast<uint16_t>((v4[0] << 8) | v4[1]);
+                groups[n++] = static_cast<uint16_t>((v4[2] << 8) | v4[3]);
+                break;
+            }
+
+            size_t digits = i - start;
+            if (digits == 0 || digits > 4) return false;
+            groups[n++] = static_cast<uint16_t>(value);
+
+            if (i == text.size()) break;
+            if (text[i++] != ':' || i == text.size()) return false; // A single ':' can't end the address
+
+            if (text[i] == ':') {
+                if (gap >= 0) return false;
+                gap = n;
+                ++i;
+            }
+        }
+
+        if (gap < 0 ? n != 8 : n == 8) return false;
+
+        // Moves the groups after "::" to the end, the ones in between are zero
+        int zeros = 8 - n;
+        for (int g = 7; gap >= 0 && g >= gap + zeros; --g) groups[g] = groups[g - zeros];
+        for (int g = gap; gap >= 0 && g < gap + zeros; ++g) groups[g] = 0;
+
+        for (int g = 0; g < 8; ++g) {
+            out[g * 2] = static_cast<uint8_t>(groups[g] >> 8);
+            out[g * 2 + 1] = static_cast<uint8_t>(groups[g]);
+        }
+        return true;
+    }
+
+    static bool parse(std::string_view text, K4IniAddress& out) noexcept {
+        K4IniAddress address;
+        if (text.find(':') != std::string_view::npos) {
+            if (!parseIPv6(text, address.bytes.data())) return false;
+            address.family = K4IniAddress::Family::IPv6;
+        }
+        else if (!parseIPv4(text, address.bytes.data())) return false;
+
+        out = address;
+        return true;
+    }
+};
+
+template<>
+struct K4IniConvert<K4IniCidr> {
+    // "address/prefix"; a lone address is a prefix covering only itself (/32 or /128).
+    // Networks with bits set past the prefix (e.g. "10.0.0.1/8") are rejected
+    static K4IniStatus parse(std::string_view text, K4IniCidr& out) noexcept {
+        K4IniCidr cidr;
+        size_t slash = text.find('/');
+
+        if (!K4IniConvert<K4IniAddress>::parse(text.substr(0, slash), cidr.network)) return K4IniStatus::Unparsable;
+
+        unsigned maxPrefix = static_cast<unsigned>(cidr.network.size() * 8);
+        unsigned prefix = maxPrefix;
+
+        if (slash != std::string_view::npos) {
+            std::string_view digits = text.substr(slash + 1);
+            if (digits.empty() || digits.size() > 3) return K4IniStatus::Unparsable;
+
+            auto result = std::from_chars(digits.data(), digits.data() + digits.size(), prefix);
+            if (result.ec != std::errc() || result.ptr != digits.data() + digits.size()) return K4IniStatus::Unparsable;
+            if (prefix > maxPrefix) return K4IniStatus::OutOfRange;
+        }
+        cidr.prefix = static_cast<uint8_t>(prefix);
+
+        for (size_t bit = prefix; bit < maxPrefix; ++bit) {
+            if (cidr.network.bytes[bit / 8] & (0x80 >> (bit % 8))) return K4IniStatus::Unparsable;
+        }
+
+        out = cidr;
+        return K4IniStatus::Ok;
+    }
+};
+
+template<>
+struct K4IniConvert<K4IniEndpoint> {
+    // "host:port", with IPv6 addresses in brackets; the port is required
+    static K4IniStatus parse(std::string_view text, K4IniEndpoint& out) {
+        static constexpr auto hostTable = [] {
+            std::array<bool, 256> table{};
+            for (unsigned char c : std::string_view("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._")) table[c] = true;
+            return table;
+        }();
+
+        K4IniEndpoint endpoint;
+        std::string_view host, port;
+
+        if (!text.empty() && text[0] == '[') {
+            size_t close = text.find(']');
+            if (close == std::string_view::npos || close + 1 >= text.size() || text[close + 1] != ':') return K4IniStatus::Unparsable;
+
+            host = text.substr(1, close - 1);
+            port = text.substr(close + 2);
+            if (!K4IniConvert<K4IniAddress>::parseIPv6(host, endpoint.address.bytes.data())) return K4IniStatus::Unparsable;
+            endpoint.address.family = K4IniAddress::Family::IPv6;
+        }
+        else {
+            size_t colon = text.find(':');
+            if (colon == std::string_view::npos || text.find(':', colon + 1) != std::string_view::npos) return K4IniStatus::Unparsable; // IPv6 addresses need brackets
+
+            host = text.substr(0, colon);
+            port = text.substr(colon + 1);
+            if (host.empty() || host.size() > 253) return K4IniStatus::Unparsable;
+
+            if (!K4IniConvert<K4IniAddress>::parseIPv4(host, endpoint.address.bytes.data())) {
+                for (char c : host) {
+                    if (!hostTable[static_cast<unsigned char>(c)]) return K4IniStatus::Unparsable;
+                }
+                endpoint.host.assign(host);
+            }
+        }
+
+        if (port.empty() || static_cast<unsigned>(port[0] - '0') >= 10) return K4IniStatus::Unparsable;
+
+        auto result = std::from_chars(port.data(), port.data() + port.size(), endpoint.port);
+        if (result.ec == std::errc::result_out_of_range) return K4IniStatus::OutOfRange;
+        if (result.ec != std::errc() || result.ptr != port.data() + port.size()) return K4IniStatus::Unparsable;
+
+        out = std::move(endpoint);
+        return K4IniStatus::Ok;
+    }
+};
+
+#ifdef K4INIREADER_COROUTINES
+class K4IniAsyncLoad;
+#endif
+
+template<size_t MaxSections, size_t MaxKeys, size_t MaxBytes, typename Dialect>
+class K4IniFixedReader;
+
+// Parsing rules of the .ini files read by K4IniReader (the default dialect).
+// Other dialects derive from it and hide the members to change; the tokenizer is specialized at compile time,
+// so disabled rules cost nothing:
+//     struct MachineIni : K4IniDialect {
+//         static constexpr bool semicolonComments = false;
+//         static constexpr bool hashComments = false;
+//         static constexpr bool slashComments = false;
+//     };
+//     K4IniReader iniReader("Generated.ini", K4IniOptions(), MachineIni());
+struct K4IniDialect {
+    static constexpr bool semicolonComments = true;        // ';' starts a comment
+    static constexpr bool hashComments = true;             // '#' starts a comment
+    static constexpr bool slashComments = true;            // "//" starts a comment
+    static constexpr bool inlineComments = true;           // Comments may follow a key-value pair or a header; if false, only whole lines are comments
+    static constexpr bool headerAnywhere = true;           // Any '[' before the delimiter starts a section header; if false, only a '[' starting the line does
+    static constexpr bool heredocValues = true;            // "key = <<EOF" takes the following lines as its value, up to a line with only "EOF"
+    static constexpr bool backslashContinuation = false;   // A line ending with '\\' continues on the next one
+    static constexpr bool indentedContinuation = false;    // Indented lines after a key-value pair add lines to its value
+    static constexpr bool quotedValues = true;             // Values in "..." or '...' keep comment markers and may contain escapes (\" \' \\ \n \t \r \0)
+    static constexpr bool collectDiagnostics = false;      // Records the malformed lines (see K4IniReader::diagnostics)
+    static constexpr bool strict = false;                  // Throws a K4IniParseError from the constructor if any line is malformed
+    static constexpr char delimiter = '=';                 // Separates a key from its value
+    static constexpr std::string_view whitespace = " \t\n\v\f\r"; // Characters trimmed around names and values
+};
+
+// Dialect collecting the problems found while loading:
+//     K4IniReader iniReader("Config.ini", K4IniOptions(), K4IniDiagnostics<>());
+//     for (const auto& d : iniReader.diagnostics()) std::cerr << d.line << ':' << d.column << ": " << d.message << '\n';
+template<typename Base = K4IniDialect>
+struct K4IniDiagnostics : Base {
+    static constexpr bool collectDiagnostics = true;
+};
+
+// Dialect failing the construction with a K4IniParseError if any problem is found
+template<typename Base = K4IniDialect>
+struct K4IniStrict : Base {
+    static constexpr bool strict = true;
+};
+
+// Problem found while loading a .ini file
+struct K4IniDiagnostic {
+    size_t line = 0;   // 1-based; 0 if the problem isn't on a line (the file can't be opened)
+    size_t column = 0; // 1-based, in bytes
+    std::string message;
+};
+
+// Thrown by the constructors of K4IniReader with a strict dialect; holds all the problems found
+class K4IniParseError : public std::runtime_error {
+private:
+    static std::string describe(const std::string& source, const K4IniDiagnostic& d) {
+        if (!d.line) return source + ": " + d.message;
+        return source + ':' + std::to_string(d.line) + ':' + std::to_string(d.column) + ": " + d.message;
+    }
+
+public:
+    std::vector<K4IniDiagnostic> diagnostics;
+
+    // 'source' is the file name, used in what() along with the first problem
+    K4IniParseError(const std::string& source, std::vector<K4IniDiagnostic> problems)
+        : std::runtime_error(describe(source, problems.front())), diagnostics(std::move(problems)) {}
+};
+
+// Name of a section or a key, with its hash computed at compile time.
+// Reading with these instead of strings skips hashing the names on every read:
+//     using namespace K4IniLiterals;
+//     iniReader.read<bool>("Graphics"_sec, "v-sync"_key, false);
+struct K4IniKey {
+    std::string_view name;
+    uint64_t hash;
+
+    // Hash of a name, 8 bytes at a time; also used for all the names stored in K4IniReader
+    static constexpr uint64_t hashName(std::string_view s) noexcept {
+        size_t n = s.size();
+        uint64_t h = 0x243F6A8885A308D3ull ^ (n * 0x9E3779B97F4A7C15ull);
+
+        if (n >= 8) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) h = mix(h, load64(s.data() + i));
+            if (i < n) h = mix(h, load64(s.data() + n - 8)); // The last 8 bytes, overlapping the previous word
+        }
+        else if (n >= 4) h = mix(h, load32(s.data()) | load32(s.data() + n - 4) << 32); // Two words of 4 bytes, overlapping if needed
+        else if (n > 0) h = mix(h, byte(s[0]) | byte(s[n / 2]) << 8 | byte(s[n - 1]) << 16);
+
+        // Final mix (MurmurHash3), so that all the bits depend on all the bytes
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    constexpr K4IniKey(std::string_view name) noexcept : name(name), hash(hashName(name)) {}
+
+private:
+    // Little-endian word of 8 bytes; assembled byte by byte so that it also works at compile time
+    // (compilers turn it into a single load)
+    static constexpr uint64_t load64(const char* p) noexcept {
+        return byte(p[0]) | byte(p[1]) << 8 | byte(p[2]) << 16 | byte(p[3]) << 24 |
+            byte(p[4]) << 32 | byte(p[5]) << 40 | byte(p[6]) << 48 | byte(p[7]) << 56;
+    }
+
+    static constexpr uint64_t load32(const char* p) noexcept { return byte(p[0]) | byte(p[1]) << 8 | byte(p[2]) << 16 | byte(p[3]) << 24; }
+
+    static constexpr uint64_t byte(char c) noexcept { return static_cast<unsigned char>(c); }
+
+    static constexpr uint64_t mix(uint64_t h, uint64_t w) noexcept {
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        return h ^ (h >> 32);
+    }
+};
+
+namespace K4IniLiterals {
+    constexpr K4IniKey operator""_sec(const char* s, size_t n) noexcept { return K4IniKey(std::string_view(s, n)); }
+    constexpr K4IniKey operator""_key(const char* s, size_t n) noexcept { return K4IniKey(std::string_view(s, n)); }
+}
 
 class K4IniReader {
 private:
-    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> data;
+    // Everything stored is allocated from the memory resource of the options (see K4IniOptions::memoryResource)
+    using Allocator = std::pmr::polymorphic_allocator<char>;
+    using String = std::pmr::string;
+
+    // Key of a NameMap: a name along with its hash.
+    // The keys stored own a copy of the name, allocated from the map's resource;
+    // the keys searched only view the name, so searching never copies it (nor hashes a K4IniKey again).
+    class MapKey {
+    private:
+        String stored;         // Copy of the name, empty for the keys searched
+        std::string_view view; // The name: 'stored', or the name searched
+        uint64_t hashValue;
+
+    public:
+        using allocator_type = Allocator;
+
+        MapKey(std::string_view name, uint64_t hash) noexcept : view(name), hashValue(hash) {}
+
+        MapKey(std::string_view name, const allocator_type& alloc) : stored(name, alloc), view(stored), hashValue(K4IniKey::hashName(name)) {}
+        MapKey(const MapKey& other, const allocator_type& alloc = allocator_type()) : stored(other.view, alloc), view(stored), hashValue(other.hashValue) {}
+
+        MapKey& operator=(const MapKey&) = delete;
+
+        inline std::string_view name() const noexcept { return view; }
+        inline uint64_t hash() const noexcept { return hashValue; }
+        inline operator std::string_view() const noexcept { return view; }
+    };
+
+    struct NameHash {
+        inline size_t operator()(const MapKey& k) const noexcept { return static_cast<size_t>(k.hash()); }
+    };
+
+    struct NameEqual {
+        inline bool operator()(const MapKey& a, const MapKey& b) const noexcept { return a.name() == b.name(); }
+    };
+
+    // Hash map of names; searched with a key viewing the name, so a K4IniKey isn't hashed again
+    template<typename V>
+    using NameMap = std::pmr::unordered_map<MapKey, V, NameHash, NameEqual>;
+
+    static inline std::string_view nameOf(std::string_view s) noexcept { return s; }
+    static inline std::string_view nameOf(const K4IniKey& k) noexcept { return k.name; }
+    static inline std::string_view nameOf(const MapKey& k) noexcept { return k.name(); }
+
+    static inline uint64_t hashOf(std::string_view s) noexcept { return K4IniKey::hashName(s); }
+    static inline uint64_t hashOf(const K4IniKey& k) noexcept { return k.hash; }
+    static inline uint64_t hashOf(const MapKey& k) noexcept { return k.hash(); }
+
+    // Key viewing a name, to search a NameMap or to insert into it (the map stores a copy)
+    template<typename Name>
+    static inline MapKey keyOf(const Name& name) noexcept { return MapKey(nameOf(name), hashOf(name)); }
+
+    // Searches a NameMap with a string, a K4IniKey or a key of another map
+    template<typename Map, typename Name>
+    static inline auto lookup(Map& map, const Name& name) { return map.find(keyOf(name)); }
+
+    // Hash of a (section, key) pair, from the hashes of the two names
+    static inline uint64_t pairHash(uint64_t sectionHash, uint64_t keyHash) noexcept {
+        uint64_t h = sectionHash * 0x9E3779B97F4A7C15ull ^ keyHash;
+
+        // Final mix (MurmurHash3), so that all the bits depend on both names
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static inline unsigned countTrailingZeros(uint32_t x) noexcept {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+    }
+
+    // Value of a key, classified when it's extracted.
+    // Numbers and booleans are stored already converted, so reading them doesn't need parsing.
+    struct Value {
+        enum class Kind : uint8_t { None, String, Integer, Float, Bool, Large }; // None marks a missing cell of a table, Large a value still in the file
+
+        using allocator_type = Allocator;
+
+        String text; // Raw value
+        union {
+            long long integer = 0; // Set if kind is Integer; index of the large value if kind is Large
+            double floating;       // Set if kind is Float
+        };
+        Kind kind = Kind::None;
+        bool truthy = false; // Result of reading the value as a boolean
+
+        Value() = default;
+        Value(const Value&) = default;
+        Value(Value&&) noexcept = default;
+        Value& operator=(const Value&) = default;
+        Value& operator=(Value&&) = default;
+
+        explicit Value(const allocator_type& alloc) : text(alloc) {}
+        Value(const Value& other, const allocator_type& alloc) : text(other.text, alloc) { copyNumber(other); }
+        Value(Value&& other, const allocator_type& alloc) : text(std::move(other.text), alloc) { copyNumber(other); }
+
+        // Copies the number (the member of the union in use), the kind and 'truthy'
+        template<typename V>
+        inline void copyNumber(const V& other) noexcept {
+            if (other.kind == Kind::Float) floating = other.floating;
+            else integer = other.integer;
+            kind = other.kind;
+            truthy = other.truthy;
+        }
+    };
+
+    static constexpr size_t printedSize = 32; // Enough for any long long or double printed by std::to_chars
+
+    // View of a value, wherever it's stored (in this reader, in a table or in a shared memory segment)
+    struct ValueRef {
+        std::string_view text;
+        union {
+            long long integer = 0; // Set if kind is Integer
+            double floating;       // Set if kind is Float
+        };
+        Value::Kind kind = Value::Kind::None;
+        bool truthy = false;
+        bool textPending = false;  // The value is a number or a boolean of a table whose text isn't printed yet (see printText)
+        char digits[printedSize];  // Text of a number of a table printed back, if 'text' points here
+
+        ValueRef() = default;
+        ValueRef(const Value& v) noexcept : text(v.text) {
+            if (v.kind == Value::Kind::Float) floating = v.floating;
+            else integer = v.integer;
+            kind = v.kind;
+            truthy = v.truthy;
+        }
+
+        ValueRef(const ValueRef& other) noexcept { *this = other; }
+
+        ValueRef& operator=(const ValueRef& other) noexcept {
+            if (this == &other) return *this;
+
+            bool isPrinted = other.text.data() == other.digits;
+            if (isPrinted) std::memcpy(digits, other.digits, other.text.size());
+            text = isPrinted ? std::string_view(digits, other.text.size()) : other.text;
+            if (other.kind == Value::Kind::Float) floating = other.floating;
+            else integer = other.integer;
+            kind = other.kind;
+            truthy = other.truthy;
+            textPending = other.textPending;
+            return *this;
+        }
+
+        // Sets the text of a number or a boolean of a table, printed only when needed
+        inline void printText() noexcept {
+            if (!textPending) return;
+
+            text = printed(*this, digits);
+            textPending = false;
+        }
+    };
+
+    // Text of a number or a boolean the way a table prints it back (the shortest text reading as the same number)
+    template<typename V>
+    static std::string_view printed(const V& v, char (&buffer)[printedSize]) noexcept {
+        if (v.kind == Value::Kind::Bool) return v.truthy ? "true" : "false";
+
+        char* end = (v.kind == Value::Kind::Float) ? std::to_chars(buffer, buffer + printedSize, v.floating).ptr
+                                                   : std::to_chars(buffer, buffer + printedSize, v.integer).ptr;
+        return std::string_view(buffer, static_cast<size_t>(end - buffer));
+    }
+
+    // Key-value pairs of a section.
+    // Small sections (the common case) keep their pairs in a contiguous array along with a 1-byte tag per key,
+    // and look keys up by comparing all the tags at once; past 'smallLimit' keys, they switch to a hash map.
+    class Section {
+    private:
+        static constexpr size_t smallLimit = 16;
+
+        using LargeMap = NameMap<Value>;
+
+        std::array<uint8_t, smallLimit> tags{};           // Tags of the small pairs, in the same order
+        std::pmr::vector<std::pair<String, Value>> pairs; // Small pairs, sized from the keys inserted
+        LargeMap* map = nullptr;                          // Pairs of a large section; only allocated once the section is large
+
+        // Allocates the map of a large section from the resource of the section, copying 'other' if set
+        LargeMap* newMap(const LargeMap* other) const {
+            std::pmr::polymorphic_allocator<LargeMap> alloc(pairs.get_allocator().resource());
+            LargeMap* m = alloc.allocate(1);
+            try {
+                if (other) alloc.construct(m, *other);
+                else alloc.construct(m);
+            }
+            catch (...) {
+                alloc.deallocate(m, 1);
+                throw;
+            }
+            return m;
+        }
+
+        void freeMap() noexcept {
+            if (!map) return;
+
+            map->~LargeMap();
+            std::pmr::polymorphic_allocator<LargeMap>(pairs.get_allocator().resource()).deallocate(map, 1);
+            map = nullptr;
+        }
+
+        // Takes the map of 'other', or copies it if the two sections don't use the same resource
+        void takeMap(Section& other) {
+            if (!other.map) return;
+
+            if (pairs.get_allocator() == other.pairs.get_allocator()) map = std::exchange(other.map, nullptr);
+            else map = newMap(other.map);
+        }
+
+        // Cheap tag of a key, computed without hashing the whole key
+        static inline uint8_t tagOf(std::string_view k) noexcept {
+            if (k.empty()) return 0;
+            return static_cast<uint8_t>(k.size() * 0x1F + static_cast<unsigned char>(k.front()) * 0x07 +
+                static_cast<unsigned char>(k[k.size() / 2]) * 0x03 + static_cast<unsigned char>(k.back()));
+        }
+
+        // Returns a bitmask with a bit set for every small pair having the given tag
+        inline uint32_t matchTags(uint8_t tag) const noexcept {
+            uint32_t matches = 0;
+#ifdef K4INIREADER_SSE2
+            __m128i all = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags.data()));
+            matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(all, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+            for (size_t i = 0; i < smallLimit; i++)
+                matches |= static_cast<uint32_t>(tags[i] == tag) << i;
+#endif
+            return matches & ((1u << pairs.size()) - 1); // Ignores the unused tags
+        }
+
+        inline size_t findSmall(std::string_view k) const noexcept {
+            for (uint32_t matches = matchTags(tagOf(k)); matches; matches &= matches - 1) {
+                size_t i = countTrailingZeros(matches);
+                if (pairs[i].first == k) return i;
+            }
+
+            return pairs.size();
+        }
+
+    public:
+        using allocator_type = Allocator;
+
+        Section() = default;
+        explicit Section(const allocator_type& alloc) : pairs(alloc) {}
+
+        Section(const Section& other, const allocator_type& alloc = allocator_type())
+            : tags(other.tags), pairs(other.pairs, alloc), map(other.map ? newMap(other.map) : nullptr) {}
+        Section(Section&& other) noexcept : tags(other.tags), pairs(std::move(other.pairs)), map(std::exchange(other.map, nullptr)) {}
+        Section(Section&& other, const allocator_type& alloc) : tags(other.tags), pairs(std::move(other.pairs), alloc) { takeMap(other); }
+
+        Section& operator=(const Section& other) {
+            if (this != &other) {
+                tags = other.tags;
+                pairs = other.pairs;
+                freeMap();
+                if (other.map) map = newMap(other.map);
+            }
+            return *this;
+        }
+
+        Section& operator=(Section&& other) {
+            if (this != &other) {
+                tags = other.tags;
+                pairs = std::move(other.pairs);
+                freeMap();
+                takeMap(other);
+            }
+            return *this;
+        }
+
+        ~Section() { freeMap(); }
+
+        inline size_t size() const noexcept { return map ? map->size() : pairs.size(); }
+
+        // Pre-allocates a section expected to hold 'nKeys' keys; only sections too big to be scanned are allocated up front,
+        // the small ones grow with their keys
+        void reserve(size_t nKeys) {
+            if (nKeys <= smallLimit) return;
+
+            if (!map) map = newMap(nullptr);
+            map->reserve(nKeys);
+        }
+
+        // Frees the unused room of the small pairs, once all the keys are inserted
+        void shrink() {
+            if (!map && pairs.capacity() > pairs.size()) pairs.shrink_to_fit();
+        }
+
+        // Returns the value of a key, or nullptr if the key was not found
+        template<typename Name>
+        inline const Value* find(const Name& k) const noexcept {
+            if (map) {
+                auto keyIt = lookup(*map, k);
+                return keyIt == map->end() ? nullptr : &keyIt->second;
+            }
+
+            size_t i = findSmall(nameOf(k)); // Compares the tags, then the lengths and the bytes of the matching keys
+            return i == pairs.size() ? nullptr : &pairs[i].second;
+        }
+
+        // Inserts a key-value pair, overriding the value if the key already exists
+        void set(std::string_view k, Value&& v) {
+            if (!map) {
+                size_t i = findSmall(k);
+                if (i < pairs.size()) {
+                    pairs[i].second = std::move(v);
+                    return;
+                }
+
+                if (pairs.size() < smallLimit) {
+                    tags[pairs.size()] = tagOf(k);
+                    pairs.emplace_back(k, std::move(v));
+                    return;
+                }
+
+                // The section is too big to be scanned: moves its pairs into a hash map
+                map = newMap(nullptr);
+                map->reserve(smallLimit * 2);
+                for (auto& pair : pairs) map->emplace(std::string_view(pair.first), std::move(pair.second));
+                decltype(pairs)(pairs.get_allocator()).swap(pairs); // Frees the small pairs
+            }
+
+            auto keyIt = lookup(*map, k);
+            if (keyIt != map->end()) keyIt->second = std::move(v);
+            else map->emplace(k, std::move(v));
+        }
+
+        // Calls 'f(key, value)' for each pair
+        template<typename F>
+        void forEach(F&& f) const {
+            if (map)
+                for (const auto& [key, value] : *map) f(key, value);
+            else
+                for (const auto& [key, value] : pairs) f(key, value);
+        }
+    };
+
+    // A section indexed but not parsed yet (lazy mode)
+    struct LazySection {
+        using allocator_type = Allocator;
+
+        std::pmr::vector<std::pair<size_t, size_t>> ranges; // Byte ranges [begin, end) of the section's bodies inside the file
+        std::once_flag parsed;                              // Makes sure that the section is parsed only once, even by concurrent readers
+        Section keys;                                       // Key-value pairs of the section, filled on the first read
+
+        explicit LazySection(const allocator_type& alloc) : ranges(alloc), keys(alloc) {}
+    };
+
+    // File content and section index kept alive for the lazy parsing
+    struct LazyIndex {
+        std::string content;
+        void (*parseSection)(const LazyIndex&, LazySection&) = nullptr; // Parser of the dialect of the file
+        size_t nKeys = 8;
+        NameMap<LazySection> sections;
+
+        explicit LazyIndex(const Allocator& alloc) : sections(alloc) {}
+    };
+
+    // Sections sharing the same keys, stored by column (table mode).
+    // Every section whose name starts with the table's prefix is a row, every key is a column,
+    // so the keys are stored once and reading a key across all the sections walks a single array.
+    // A cell is a tag byte (kind and flags) plus 8 bytes holding its number; strings keep their text in one buffer
+    // shared by the table, and the 8 bytes hold its place instead. Numbers and booleans only keep their text
+    // if it isn't the way they are printed back ("0x10", "1.50", "yes"), and get converted again when read.
+    struct Table {
+        using allocator_type = Allocator;
+
+        static constexpr uint8_t kindMask = 0x07;
+        static constexpr uint8_t truthyBit = 0x08; // Result of reading the value as a boolean
+        static constexpr uint8_t textBit = 0x10;   // The text is in 'texts', its place in the payload (offset << 32 | length)
+
+        String prefix;
+        NameMap<size_t> rowIndex;                              // Section name -> row
+        std::pmr::vector<std::string_view> rowNames;           // Row -> section name (the key stored in 'rowIndex')
+        NameMap<size_t> columnIndex;                           // Key -> column
+        std::pmr::vector<std::pmr::vector<uint8_t>> tags;      // Tags of the cells, by column and then by row
+        std::pmr::vector<std::pmr::vector<uint64_t>> payloads; // Number, index of a large value, or place of the text of the cells
+        String texts;                                          // Text of the cells keeping it
+
+        Table(std::string_view prefix, const allocator_type& alloc)
+            : prefix(prefix, alloc), rowIndex(alloc), rowNames(alloc), columnIndex(alloc), tags(alloc), payloads(alloc), texts(alloc) {}
+
+        Table(const Table& other, const allocator_type& alloc = allocator_type())
+            : prefix(other.prefix, alloc), rowIndex(other.rowIndex, alloc), rowNames(other.rowNames.size(), alloc),
+              columnIndex(other.columnIndex, alloc), tags(other.tags, alloc), payloads(other.payloads, alloc), texts(other.texts, alloc) {
+            for (const auto& [name, row] : rowIndex) rowNames[row] = name; // Views of the names just copied
+        }
+        Table(Table&& other) noexcept = default; // The nodes of 'rowIndex' are moved along, so 'rowNames' stays valid
+        Table(Table&& other, const allocator_type& alloc)
+            : Table(other.prefix.get_allocator() == alloc ? Table(std::move(other)) : Table(other, alloc)) {}
+
+        Table& operator=(const Table& other) {
+            if (this != &other) {
+                Table copy(other, prefix.get_allocator());
+                swap(copy);
+            }
+            return *this;
+        }
+
+        Table& operator=(Table&& other) {
+            if (prefix.get_allocator() == other.prefix.get_allocator()) swap(other);
+            else *this = static_cast<const Table&>(other);
+            return *this;
+        }
+
+        // Swaps with a table using the same resource
+        void swap(Table& other) noexcept {
+            prefix.swap(other.prefix);
+            rowIndex.swap(other.rowIndex);
+            rowNames.swap(other.rowNames);
+            columnIndex.swap(other.columnIndex);
+            tags.swap(other.tags);
+            payloads.swap(other.payloads);
+            texts.swap(other.texts);
+        }
+
+        // Returns the row of a section, adding it if it's new
+        size_t addRow(std::string_view name) {
+            auto rowIt = lookup(rowIndex, name);
+            if (rowIt != rowIndex.end()) return rowIt->second;
+
+            rowIt = rowIndex.emplace(name, rowNames.size()).first;
+            rowNames.push_back(rowIt->first);
+            for (auto& column : tags) column.push_back(0); // Missing cells
+            for (auto& column : payloads) column.push_back(0);
+
+            return rowNames.size() - 1;
+        }
+
+        void set(size_t row, std::string_view key, const Value& v) {
+            auto columnIt = lookup(columnIndex, key);
+            if (columnIt == columnIndex.end()) {
+                columnIt = columnIndex.emplace(key, tags.size()).first;
+                tags.emplace_back(rowNames.size()); // Missing cells
+                payloads.emplace_back(rowNames.size());
+            }
+
+            uint8_t tag = static_cast<uint8_t>(v.kind) | (v.truthy ? truthyBit : 0);
+            uint64_t payload = 0;
+
+            char buffer[printedSize];
+            if (v.kind == Value::Kind::Large) payload = static_cast<uint64_t>(v.integer);
+            else if (v.kind != Value::Kind::String && printed(v, buffer) == std::string_view(v.text)) {
+                if (v.kind == Value::Kind::Float) std::memcpy(&payload, &v.floating, sizeof(payload));
+                else payload = static_cast<uint64_t>(v.integer);
+            }
+            else { // The text is kept (the text of an overridden cell stays in the buffer)
+                if (texts.size() > UINT32_MAX || v.text.size() > UINT32_MAX) throw std::length_error("K4IniReader: text of a table over 4 GiB");
+
+                tag |= textBit;
+                payload = static_cast<uint64_t>(texts.size()) << 32 | v.text.size();
+                texts += v.text;
+            }
+
+            tags[columnIt->second][row] = tag;
+            payloads[columnIt->second][row] = payload;
+        }
+
+        // Frees the unused room of the columns, once all the rows are added
+        void shrink() {
+            for (auto& column : tags) column.shrink_to_fit();
+            for (auto& column : payloads) column.shrink_to_fit();
+            texts.shrink_to_fit();
+        }
+
+        inline bool has(size_t column, size_t row) const noexcept { return (tags[column][row] & kindMask) != 0; }
+
+        // Gets a cell; a large value is only given by its index (kind Large)
+        inline void cell(size_t column, size_t row, ValueRef& out) const noexcept {
+            uint8_t tag = tags[column][row];
+            uint64_t payload = payloads[column][row];
+
+            out.kind = static_cast<Value::Kind>(tag & kindMask);
+            out.truthy = (tag & truthyBit) != 0;
+
+            if (tag & textBit) {
+                cellWithText(payload, out);
+                return;
+            }
+
+            if (out.kind == Value::Kind::Float) std::memcpy(&out.floating, &payload, sizeof(payload));
+            else out.integer = static_cast<long long>(payload);
+
+            out.text = std::string_view();
+            out.textPending = out.kind != Value::Kind::Large && out.kind != Value::Kind::None; // Printed if needed, reading numbers doesn't use it
+        }
+
+        // Gets a cell keeping its text, converting its number again
+        void cellWithText(uint64_t payload, ValueRef& out) const noexcept {
+            out.text = std::string_view(texts.data() + (payload >> 32), static_cast<uint32_t>(payload));
+            out.integer = 0;
+            out.textPending = false;
+            if (out.kind == Value::Kind::Integer || out.kind == Value::Kind::Float) classify(out.text, out);
+        }
+
+        template<typename Name>
+        inline bool find(size_t row, const Name& key, ValueRef& out) const noexcept {
+            auto columnIt = lookup(columnIndex, key);
+            if (columnIt == columnIndex.end() || !has(columnIt->second, row)) return false; // The key was not found
+
+            cell(columnIt->second, row, out);
+            return true;
+        }
+    };
+
+    // A value left in the file, read on its first access
+    struct LargeValue {
+        uint64_t offset;
+        size_t length;
+        std::once_flag read; // Makes sure that the value is read only once, even by concurrent readers
+        Value value;         // The value read; stays of kind None if the file couldn't be read
+
+        LargeValue(uint64_t offset, size_t length, const Allocator& alloc) : offset(offset), length(length), value(alloc) {}
+    };
+
+    // File the large values are read from (see K4IniOptions::largeValueBytes).
+    // On POSIX, the file stays open, so the values still come from the file loaded even if it's replaced later.
+    struct LargeValueFile {
+#ifdef K4INIREADER_POSIX
+        int fd = -1;
+
+        ~LargeValueFile() {
+            if (fd >= 0) ::close(fd);
+        }
+
+        inline bool isOpen() const noexcept { return fd >= 0; }
+#else
+        std::string fileName;
+
+        inline bool isOpen() const noexcept { return !fileName.empty(); }
+#endif
+        std::pmr::deque<LargeValue> values; // A deque doesn't move the values, which can't be moved because of their once_flag
+        size_t contentOffset = 0;           // Offset of the content in the file (the size of a byte order mark removed)
+
+        explicit LargeValueFile(const Allocator& alloc) : values(alloc) {}
+        LargeValueFile(const LargeValueFile&) = delete;
+        LargeValueFile& operator=(const LargeValueFile&) = delete;
+
+        // Reads 'out.size()' bytes at 'offset'
+        bool read(uint64_t offset, std::string& out) const {
+#ifdef K4INIREADER_POSIX
+            for (size_t done = 0; done < out.size();) {
+                ssize_t n = ::pread(fd, out.data() + done, out.size() - done, static_cast<off_t>(offset + done));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+
+                done += static_cast<size_t>(n);
+            }
+
+            return true;
+#else
+            std::ifstream file(fileName, std::ios::binary);
+            file.seekg(static_cast<std::streamoff>(offset));
+            file.read(out.data(), static_cast<std::streamsize>(out.size()));
+            return file && static_cast<size_t>(file.gcount()) == out.size();
+#endif
+        }
+    };
+
+    enum class LineType { None, Section, KeyValue };
+
+    // Whether a dialect checks the lines it parses
+    template<typename Dialect>
+    static constexpr bool checks = Dialect::collectDiagnostics || Dialect::strict;
+
+    // Problem found on a line by the tokenizer (only with dialects checking the lines)
+    struct LineIssue {
+        std::string message;
+        size_t column = 0; // Offset in the line
+    };
+
+    // Turns the issues found on the lines of a content into diagnostics; the lines are only counted when there's an issue
+    struct DiagnosticSink {
+        const std::string& content;
+        std::vector<K4IniDiagnostic>& out;
+        size_t countedPos = 0;
+        size_t countedLines = 1;
+        LineIssue issue{};
+
+        void flush(size_t lineStart) {
+            if (issue.message.empty()) return;
+
+            countedLines += static_cast<size_t>(std::count(content.begin() + countedPos, content.begin() + lineStart, '\n'));
+            countedPos = lineStart;
+
+            out.push_back({ countedLines, issue.column + 1, std::move(issue.message) });
+            issue = LineIssue();
+        }
+    };
+
+#ifdef K4INIREADER_POSIX
+    // Layout of a segment published in shared memory.
+    // Everything is addressed by offsets from the start of the segment, so it can be mapped anywhere.
+    // The pairs are stored in an open addressing hash table, followed by all the strings.
+    static constexpr uint64_t sharedMagic = 0x334D48534934344Bull; // "K44ISHM3"
+
+    struct SharedHeader {
+        uint64_t magic;
+        uint64_t nSlots;      // Power of two, at least twice the number of pairs
+        uint64_t slotsOffset;
+        uint64_t size;        // Size of the whole segment
+    };
+
+    struct SharedSlot {
+        uint64_t hash;
+        uint64_t sectionOffset;
+        uint64_t keyOffset;
+        uint64_t textOffset;
+        uint32_t sectionLength;
+        uint32_t keyLength;
+        uint64_t textLength;
+        long long integer;
+        double floating;
+        Value::Kind kind; // None marks an empty slot
+        bool truthy;
+    };
+
+    // Small segment holding the generation currently published (the segment '<name>.<generation>')
+    struct SharedControl {
+        std::atomic<uint64_t> generation; // Published, read by the attached readers
+        std::atomic<uint64_t> claimed;    // Last generation taken by a publisher, so that concurrent publishers never write the same segment
+    };
+
+    // Segments mapped by an attached reader
+    struct SharedMapping {
+        const char* base = nullptr;
+        size_t size = 0;
+        const SharedControl* control = nullptr;
+        uint64_t generation = 0;
+
+        ~SharedMapping() {
+            if (base) ::munmap(const_cast<char*>(base), size);
+            if (control) ::munmap(const_cast<SharedControl*>(control), sizeof(SharedControl));
+        }
+    };
+#endif
+
+    // Blocked Bloom filter over the (section, key) pairs.
+    // Every pair sets 3 bits of a single 64-bit word, so a missing key is usually rejected by touching one cache line.
+    class KeyFilter {
+    private:
+        std::pmr::vector<uint64_t> words;
+        uint64_t wordMask = 0;
+
+        static inline uint64_t bitsOf(uint64_t h) noexcept {
+            return (1ull << (h & 63)) | (1ull << ((h >> 6) & 63)) | (1ull << ((h >> 12) & 63));
+        }
+
+    public:
+        KeyFilter() = default;
+        explicit KeyFilter(const Allocator& alloc) : words(alloc) {}
+
+        inline bool empty() const noexcept { return words.empty(); }
+
+        // Allocates a power of two number of words for 'nPairs' pairs
+        void reset(size_t nPairs, size_t bitsPerKey) {
+            size_t nWords = 1;
+            while (nWords * 64 < nPairs * bitsPerKey) nWords <<= 1;
+
+            words.assign(nWords, 0);
+            wordMask = nWords - 1;
+        }
+
+        inline void insert(uint64_t h) noexcept { words[(h >> 32) & wordMask] |= bitsOf(h); }
+
+        inline bool mayContain(uint64_t h) const noexcept {
+            uint64_t bits = bitsOf(h);
+            return (words[(h >> 32) & wordMask] & bits) == bits;
+        }
+    };
+
+    NameMap<Section> data;
+    std::shared_ptr<LazyIndex> lazyIndex; // Only set in lazy mode; shared so that copies of the reader use the same index
+    KeyFilter keyFilter;                  // Empty unless requested with 'filterBitsPerKey'
+    std::pmr::vector<Table> tables;       // Tables requested with 'tables'
+    bool opened = false;                  // Whether the file could be opened
+    std::shared_ptr<LargeValueFile> largeValues; // Only set when values are left in the file ('largeValueBytes')
+    size_t encodingErrorOffset = std::string::npos; // Offset in the file of the first invalid UTF-8 sequence (if validated)
+    std::vector<K4IniDiagnostic> diagnosticList;     // Problems found, with dialects collecting them
+#ifdef K4INIREADER_POSIX
+    std::shared_ptr<const SharedMapping> shared; // Only set for readers attached to a shared memory segment
+#endif
+
+    // Lookup table of the characters in 'chars'.
+    // Character classes come from these tables rather than <cctype>, so they don't depend on the C locale (setlocale).
+    static constexpr std::array<bool, 256> charTable(std::string_view chars) noexcept {
+        std::array<bool, 256> table{};
+        for (char c : chars) table[static_cast<unsigned char>(c)] = true;
+        return table;
+    }
+
+    template<typename Dialect>
+    static constexpr std::array<bool, 256> spaceTable = charTable(Dialect::whitespace);
+
+    template<typename Dialect>
+    static inline bool isSpace(char ch) noexcept { return spaceTable<Dialect>[static_cast<unsigned char>(ch)]; }
+
+    // Returns the position of the first non-whitespace character from 'pos', or npos if there's none
+    template<typename Dialect>
+    static inline size_t skipSpaces(std::string_view s, size_t pos = 0) noexcept {
+        while (pos < s.size() && isSpace<Dialect>(s[pos])) pos++;
+        return pos < s.size() ? pos : std::string_view::npos;
+    }
+
+    // Returns a string without its leading and trailing whitespaces
+    template<typename Dialect>
+    static inline std::string_view trimmed(std::string_view s) noexcept {
+        size_t first = 0, last = s.size();
+        while (first < last && isSpace<Dialect>(s[first])) first++;
+        while (last > first && isSpace<Dialect>(s[last - 1])) last--;
+        return s.substr(first, last - first);
+    }
+
+    // Lowers the ASCII letters of a string, 16 characters at a time when SSE2 is available (other bytes are kept)
+    static inline void toLowerAscii(std::string& s) noexcept {
+        size_t i = 0;
+#ifdef K4INIREADER_SSE2
+        const __m128i beforeA = _mm_set1_epi8('A' - 1);
+        const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        for (; s.size() - i >= 16; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.data() + i));
+            __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chunk, beforeA), _mm_cmplt_epi8(chunk, afterZ)); // Bytes >= 0x80 are negative, so never upper
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(s.data() + i), _mm_or_si128(chunk, _mm_and_si128(upper, caseBit)));
+        }
+#endif
+        for (; i < s.size(); i++)
+            if (s[i] >= 'A' && s[i] <= 'Z') s[i] = static_cast<char>(s[i] | 0x20);
+    }
+
+    // Records the first issue of a line, if there's somewhere to record it
+    static inline void flagIssue(LineIssue* issue, size_t column, std::string message) {
+        if (issue && issue->message.empty()) {
+            issue->message = std::move(message);
+            issue->column = column;
+        }
+    }
+
+    // Removes leading and trailing whitespaces from a string
+    template<typename Dialect>
+    static inline void trim(std::string& s) noexcept {
+        // Trim from start
+        s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](char ch) { return !isSpace<Dialect>(ch); }));
+
+        // Trim from end
+        s.erase(std::find_if(s.rbegin(), s.rend(), [](char ch) { return !isSpace<Dialect>(ch); }).base(), s.end());
+    }
+
+    // Returns the position of the comment in a string, or npos if there's none.
+    // Supports the comment markers enabled by the dialect ("//", ";", and "#" by default).
+    // If multiple markers are present, returns the first one found.
+    template<typename Dialect>
+    static inline size_t findComment(std::string_view s) noexcept {
+        if constexpr (Dialect::semicolonComments || Dialect::hashComments || Dialect::slashComments) { // Nothing to scan for otherwise
+            char markers[3];
+            size_t nMarkers = 0;
+            if constexpr (Dialect::semicolonComments) markers[nMarkers++] = ';';
+            if constexpr (Dialect::hashComments) markers[nMarkers++] = '#';
+            if constexpr (Dialect::slashComments) markers[nMarkers++] = '/';
+
+            if constexpr (!Dialect::inlineComments) { // Only a marker starting the line makes it a comment
+                size_t first = skipSpaces<Dialect>(s);
+                if (first != std::string_view::npos && std::find(markers, markers + nMarkers, s[first]) != markers + nMarkers &&
+                    (s[first] != '/' || (first + 1 < s.size() && s[first + 1] == '/')))
+                    return first;
+            }
+            else {
+                for (size_t pos = s.find_first_of(markers, 0, nMarkers); pos != std::string_view::npos; pos = s.find_first_of(markers, pos + 1, nMarkers)) {
+                    if (s[pos] != '/' || (pos + 1 < s.size() && s[pos + 1] == '/')) // A single slash isn't a comment
+                        return pos;
+                }
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
+    // Removes any comment from a string
+    template<typename Dialect>
+    static inline void removeInlineComment(std::string& s) noexcept {
+        size_t pos = findComment<Dialect>(s);
+        if (pos != std::string::npos) s.erase(pos);
+    }
+
+    // Returns the first 'quote' or backslash in [p, last), or 'last' if there's none.
+    // Scans 16 bytes at a time when SSE2 is available.
+    static inline const char* findQuoteOrEscape(const char* p, const char* last, char quote) noexcept {
+#ifdef K4INIREADER_SSE2
+        const __m128i quotes = _mm_set1_epi8(quote);
+        const __m128i backslashes = _mm_set1_epi8('\\');
+        for (; last - p >= 16; p += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            uint32_t matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, backslashes))));
+            if (matches) return p + countTrailingZeros(matches);
+        }
+#endif
+        while (p < last && *p != quote && *p != '\\') p++;
+        return p;
+    }
+
+    // Parses a key-value pair whose value is quoted, keeping the comment markers inside the quotes.
+    // A value without escapes is copied at once; otherwise only the escapes are replaced.
+    // Returns false if the line isn't such a pair (or the quote isn't closed), to parse it as usual.
+    template<typename Dialect>
+    static inline bool parseQuoted(const std::string& line, std::string& name, std::string& value, [[maybe_unused]] LineIssue* issue) {
+        size_t posDelimiter = line.find(Dialect::delimiter);
+        if (posDelimiter == std::string::npos) return false;
+
+        size_t posQuote = skipSpaces<Dialect>(line, posDelimiter + 1);
+        if (posQuote == std::string::npos || (line[posQuote] != '"' && line[posQuote] != '\'')) return false;
+
+        std::string_view key(line.data(), posDelimiter);
+        if (key.find('[') != std::string_view::npos || findComment<Dialect>(key) != std::string_view::npos) return false; // A header or a comment
+
+        const char quote = line[posQuote];
+        const char* last = line.data() + line.size();
+
+        value.clear();
+        for (const char* p = line.data() + posQuote + 1;;) {
+            const char* stop = findQuoteOrEscape(p, last, quote);
+            if (stop == last || (stop + 1 == last && *stop == '\\')) { // The quote isn't closed
+                if constexpr (checks<Dialect>) flagIssue(issue, posQuote, "unterminated quoted value");
+                return false;
+            }
+
+            value.append(p, stop);
+            if (*stop == quote) break; // Anything after the closing quote is ignored
+
+            switch (stop[1]) {
+            case 'n': value += '\n'; break;
+            case 't': value += '\t'; break;
+            case 'r': value += '\r'; break;
+            case '0': value += '\0'; break;
+            default: value += stop[1]; break; // \", \', \\ and any other escaped character
+            }
+            p = stop + 2;
+        }
+
+        name.assign(key);
+        trim<Dialect>(name);
+        return true;
+    }
+
+    // Parses a single line of a .ini file.
+    // A section header stores its name in 'name', a key-value pair stores its key in 'name' and its value in 'value'
+    // ('quoted' tells whether the value was written between quotes).
+    template<typename Dialect>
+    static inline LineType parseLine(std::string& line, std::string& name, std::string& value, bool& quoted, [[maybe_unused]] LineIssue* issue = nullptr) {
+        quoted = false;
+
+        if constexpr (Dialect::quotedValues) {
+            if (parseQuoted<Dialect>(line, name, value, issue)) {
+                quoted = true;
+                if constexpr (checks<Dialect>) {
+                    if (name.empty()) flagIssue(issue, line.find(Dialect::delimiter), "empty key");
+                }
+                return LineType::KeyValue;
+            }
+        }
+
+        removeInlineComment<Dialect>(line); // Removes inline comments before processing the line
+
+        if (line.empty()) return LineType::None; // Skips empty lines
+
+        size_t posBracketStart = line.find('['); // Finds the position of the open square bracket
+        size_t posEqualSing = line.find(Dialect::delimiter); // Finds the position of the equal sign
+
+        if constexpr (!Dialect::headerAnywhere) { // The bracket must start the line
+            if (posBracketStart != std::string::npos && skipSpaces<Dialect>(line) != posBracketStart)
+                posBracketStart = std::string::npos;
+        }
+
+        if (posBracketStart > posEqualSing) posBracketStart = std::string::npos; // A bracket after the delimiter is part of the value (e.g. "[::1]:443")
+
+        if (posBracketStart != std::string::npos) { // If there is an open square bracket, checks if further ahead there's a close one.
+            size_t posBracketEnd = line.find(']', posBracketStart);
+            if (posBracketEnd == std::string::npos) { // If it wasn't found, skips to the next line
+                if constexpr (checks<Dialect>) flagIssue(issue, posBracketStart, "unterminated section header, missing ']'");
+                return LineType::None;
+            }
+
+            name = line.substr(posBracketStart + 1, posBracketEnd - posBracketStart - 1); // Extract the content between the two brackets
+            trim<Dialect>(name); // Remove leading and trailing whitespaces
+
+            if constexpr (checks<Dialect>) {
+                if (name.empty()) flagIssue(issue, posBracketStart, "empty section name");
+                size_t posExtra = skipSpaces<Dialect>(line, posBracketEnd + 1);
+                if (posExtra != std::string::npos) flagIssue(issue, posExtra, "unexpected text after ']'");
+            }
+            return LineType::Section;
+        }
+        else if (posEqualSing != std::string::npos) { // If there's an equal sign
+            name = line.substr(0, posEqualSing); // Extracts the key
+            trim<Dialect>(name); // Removes leading and trailing whitespaces
+
+            value = line.substr(posEqualSing + 1); // Extracts the value
+            trim<Dialect>(value); // Removes leading and trailing whitespaces
+
+            if constexpr (checks<Dialect>) {
+                if (name.empty()) flagIssue(issue, posEqualSing, "empty key");
+            }
+            return LineType::KeyValue;
+        }
+
+        if constexpr (checks<Dialect>) {
+            size_t posText = skipSpaces<Dialect>(line);
+            if (posText != std::string::npos) flagIssue(issue, posText, std::string("missing '") + Dialect::delimiter + "' after the key");
+        }
+        return LineType::None;
+    }
+
+    // Returns whether a value opens a heredoc ("<<" followed by a tag made of letters, digits and underscores)
+    static inline bool isHeredoc(std::string_view value) noexcept {
+        static constexpr std::array<bool, 256> tagTable = charTable("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_");
+
+        return value.size() > 2 && value[0] == '<' && value[1] == '<' &&
+            std::all_of(value.begin() + 2, value.end(), [](char ch) { return tagTable[static_cast<unsigned char>(ch)]; });
+    }
+
+    // Parses the logical line starting at 'lineStart' (and ending before 'end'), then moves 'lineStart' to the line after it.
+    // Depending on the dialect, a logical line spans several lines of the content; a heredoc value is copied at once from the content.
+    // If 'valueOffset' is given, it's set to where the value may be found as is in the content (npos if it can't).
+    // Dialects checking the lines record the problems found in 'issue', if given.
+    template<typename Dialect>
+    static LineType nextLine(const std::string& content, size_t& lineStart, size_t end, std::string& line, std::string& name, std::string& value,
+        size_t* valueOffset = nullptr, LineIssue* issue = nullptr) {
+        size_t physicalStart = lineStart;
+        size_t lineEnd = std::min(content.find('\n', lineStart), end);
+        line.assign(content, lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        bool joined = false; // Whether the line spans several lines of the content
+
+        if constexpr (Dialect::backslashContinuation) {
+            // Joins the next line without its leading whitespaces, while the line ends with a backslash
+            while (lineStart < end) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.empty() || line.back() != '\\') break;
+
+                line.pop_back();
+                joined = true;
+                lineEnd = std::min(content.find('\n', lineStart), end);
+                size_t textStart = std::min(skipSpaces<Dialect>(std::string_view(content.data(), lineEnd), lineStart), lineEnd);
+                line.append(content, textStart, lineEnd - textStart);
+                lineStart = lineEnd + 1;
+            }
+        }
+
+        bool quoted = false;
+        LineType type = parseLine<Dialect>(line, name, value, quoted, issue);
+        if (type != LineType::KeyValue) return type;
+
+        if (valueOffset) {
+            // Comments are only removed from the end of the line, so the value starts after the delimiter like in the content
+            // (the caller compares the content before using it, e.g. for quoted values)
+            size_t valueStart = skipSpaces<Dialect>(line, line.find(Dialect::delimiter) + 1);
+            *valueOffset = (joined || valueStart == std::string::npos) ? std::string::npos : physicalStart + valueStart;
+        }
+
+        if constexpr (Dialect::heredocValues) {
+            if (!quoted && isHeredoc(value)) { // A quoted "<<TAG" is only text
+                // The value is everything between the opening line and the terminator; without a terminator, "<<TAG" is kept as the value
+                for (size_t bodyLine = lineStart; bodyLine < end;) {
+                    size_t bodyLineEnd = std::min(content.find('\n', bodyLine), end);
+                    std::string_view text = trimmed<Dialect>(std::string_view(content.data() + bodyLine, bodyLineEnd - bodyLine));
+
+                    if (text == std::string_view(value).substr(2)) {
+                        size_t bodyEnd = (bodyLine > lineStart) ? bodyLine - 1 : lineStart; // Excludes the last line break
+                        if (bodyEnd > lineStart && content[bodyEnd - 1] == '\r') bodyEnd--;
+
+                        if (valueOffset) *valueOffset = lineStart;
+                        value.assign(content, lineStart, bodyEnd - lineStart);
+                        lineStart = bodyLineEnd + 1;
+                        return type;
+                    }
+
+                    bodyLine = bodyLineEnd + 1;
+                }
+
+                if constexpr (checks<Dialect>) flagIssue(issue, skipSpaces<Dialect>(line, line.find(Dialect::delimiter) + 1), "heredoc '" + value + "' without terminator");
+            }
+        }
+
+        if constexpr (Dialect::indentedContinuation) {
+            // Every indented line adds a line to the value, until a blank one
+            while (lineStart < end && (content[lineStart] == ' ' || content[lineStart] == '\t')) {
+                lineEnd = std::min(content.find('\n', lineStart), end);
+                line.assign(content, lineStart, lineEnd - lineStart);
+                removeInlineComment<Dialect>(line);
+                trim<Dialect>(line);
+                if (line.empty()) break;
+
+                if (valueOffset) *valueOffset = std::string::npos;
+                value += '\n';
+                value += line;
+                lineStart = lineEnd + 1;
+            }
+        }
+
+        return type;
+    }
+
+    // Classifies a value and converts it if it's a number or a boolean ('V' is Value or ValueRef)
+    template<typename V>
+    static void classify(std::string_view t, V& v) noexcept {
+        const char* first = t.data();
+        const char* last = first + t.size();
+
+        K4IniConvert<bool>::parse(t, v.truthy);
+
+        long long integer = 0;
+        auto intResult = std::from_chars(first, last, integer);
+        if (intResult.ec == std::errc() && intResult.ptr == last) { // The whole value is an integer
+            v.integer = integer;
+            v.kind = Value::Kind::Integer;
+            return;
+        }
+
+        double floating = 0;
+        auto floatResult = std::from_chars(first, last, floating);
+        if (floatResult.ec == std::errc() && floatResult.ptr == last) { // The whole value is a floating point number
+            v.floating = floating;
+            v.kind = Value::Kind::Float;
+            return;
+        }
+
+        v.integer = 0;
+        v.kind = (v.truthy || t == "false" || t == "off" || t == "no") ? Value::Kind::Bool : Value::Kind::String;
+    }
+
+    // Copies a value parsed into the storage of the reader ('alloc'), classifying it
+    static Value makeValue(std::string_view text, const Allocator& alloc) {
+        Value v(alloc);
+        v.text.assign(text);
+        classify(v.text, v);
+        return v;
+    }
+
+    inline Allocator allocator() const noexcept { return data.get_allocator(); }
+
+    // Leaves a value in the file if it's found there as is at 'offset', otherwise stores it like any other value
+    Value makeLargeValue(const std::string& text, size_t offset, const std::string& content) {
+        if (offset == std::string::npos || content.compare(offset, text.size(), text) != 0) return makeValue(text, allocator());
+
+        Value v(allocator());
+        v.kind = Value::Kind::Large;
+        v.integer = static_cast<long long>(largeValues->values.size());
+        largeValues->values.emplace_back(largeValues->contentOffset + offset, text.size(), allocator());
+        return v;
+    }
+
+    // Replaces a large value with the value read; returns false if the value is missing or couldn't be read
+    inline bool resolve(ValueRef& v) const {
+        if (v.kind == Value::Kind::Large) v = ValueRef(readLarge(v.integer));
+        return v.kind != Value::Kind::None;
+    }
+
+    // Returns a large value, read on its first access (kind None if it couldn't be read)
+    const Value& readLarge(long long index) const {
+        LargeValue& large = largeValues->values[static_cast<size_t>(index)];
+        std::call_once(large.read, [&] {
+            std::string text(large.length, '\0');
+            if (largeValues->read(large.offset, text)) large.value = makeValue(text, large.value.text.get_allocator());
+        });
+
+        return large.value;
+    }
+
+    // Parses the key-value pairs of a lazy section (called once, on its first read)
+    template<typename Dialect>
+    static void parseLazySection(const LazyIndex& index, LazySection& section) {
+        section.keys.reserve(index.nKeys); // Reserve keys for this section
+
+        std::string line, key, value;
+        for (const auto& [begin, end] : section.ranges) {
+            for (size_t lineStart = begin; lineStart < end;) {
+                if (nextLine<Dialect>(index.content, lineStart, end, line, key, value) == LineType::KeyValue)
+                    section.keys.set(key, makeValue(value, index.sections.get_allocator())); // Later pairs override the earlier ones, like in a regular load
+            }
+        }
+
+        section.keys.shrink();
+    }
+
+    enum class Compression { None, Gzip, Zstd };
+
+    static constexpr size_t compressedChunkSize = 64 * 1024; // Size of the compressed chunks read at once
+
+    // Largest content size believed from a file's header or trailer (deflate can't expand more than ~1032:1),
+    // so that a corrupted size doesn't allocate a huge buffer; larger contents still decompress, growing the output
+    static constexpr uint64_t plausibleSize(uint64_t compressedSize) noexcept { return compressedSize * 1032 + 64; }
+
+    // Recognizes the compressed formats supported by their magic bytes
+    static inline Compression detectCompression(const unsigned char* magic, size_t size) noexcept {
+#ifdef K4INIREADER_ZLIB
+        if (size >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) return Compression::Gzip;
+#endif
+#ifdef K4INIREADER_ZSTD
+        if (size >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) return Compression::Zstd;
+#endif
+        (void)magic;
+        (void)size;
+        return Compression::None;
+    }
+
+#ifdef K4INIREADER_ZLIB
+    // Decompresses a gzip stream chunk by chunk; 'readChunk(buffer, size)' returns the bytes read, 0 at the end or -1 on errors
+    template<typename Read>
+    static bool decompressGzip(Read&& readChunk, std::string& out, size_t sizeHint) {
+        z_stream stream{};
+        if (inflateInit2(&stream, 15 + 32) != Z_OK) return false; // 15 + 32: gzip or zlib header, detected automatically
+
+        std::vector<char> in(compressedChunkSize);
+        out.resize(sizeHint ? sizeHint : compressedChunkSize); // Sized once if the trailer told the size, so the output is never copied
+
+        size_t done = 0;
+        bool eof = false;
+        int status = Z_OK;
+
+        for (;;) {
+            if (stream.avail_in == 0 && !eof) {
+                long n = readChunk(in.data(), in.size());
+                if (n < 0) break;
+                if (n == 0) eof = true;
+
+                stream.next_in = reinterpret_cast<Bytef*>(in.data());
+                stream.avail_in = static_cast<uInt>(n);
+            }
+
+            if (status == Z_STREAM_END) {
+                if (stream.avail_in == 0) break; // End of the last member
+                inflateReset(&stream);         // Concatenated gzip members
+            }
+
+            if (done == out.size()) out.resize(out.size() * 2);
+
+            stream.next_out = reinterpret_cast<Bytef*>(out.data() + done);
+            stream.avail_out = static_cast<uInt>(std::min<size_t>(out.size() - done, std::numeric_limits<uInt>::max()));
+
+            status = inflate(&stream, Z_NO_FLUSH);
+            done = reinterpret_cast<char*>(stream.next_out) - out.data();
+
+            if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) break; // Corrupted data
+            if (eof && stream.avail_in == 0 && status != Z_STREAM_END && stream.avail_out != 0) break; // Truncated data
+        }
+
+        inflateEnd(&stream);
+        out.resize(done);
+        out.shrink_to_fit(); // Frees what was grown past the content, if the size wasn't known
+        return status == Z_STREAM_END;
+    }
+#endif
+
+#ifdef K4INIREADER_ZSTD
+    // Decompresses a zstd stream chunk by chunk; 'readChunk(buffer, size)' returns the bytes read, 0 at the end or -1 on errors
+    template<typename Read>
+    static bool decompressZstd(Read&& readChunk, std::string& out, uint64_t compressedSize) {
+        ZSTD_DStream* stream = ZSTD_createDStream();
+        if (!stream) return false;
+        ZSTD_initDStream(stream);
+
+        std::vector<char> in(ZSTD_DStreamInSize());
+        ZSTD_inBuffer input{ in.data(), 0, 0 };
+        out.clear();
+
+        size_t done = 0;
+        size_t remaining = 1; // 0 once a whole frame was decoded
+        bool eof = false;
+        bool ok = false;
+
+        for (;;) {
+            if (input.pos == input.size && !eof) {
+                long n = readChunk(in.data(), in.size());
+                if (n < 0) break;
+                if (n == 0) eof = true;
+
+                input.size = static_cast<size_t>(n);
+                input.pos = 0;
+
+                if (out.empty()) { // First chunk: the frame header may tell the size of the content, so the output is sized once
+                    unsigned long long contentSize = ZSTD_getFrameContentSize(in.data(), input.size);
+                    bool known = contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR && contentSize > 0 &&
+                        contentSize <= plausibleSize(compressedSize);
+                    out.resize(known ? static_cast<size_t>(contentSize) : ZSTD_DStreamOutSize());
+                }
+            }
+
+            // Everything was read and flushed (decoding again would start a new frame, so it stops here)
+            if (eof && input.pos == input.size && (remaining == 0 || done < out.size())) {
+                ok = (remaining == 0);
+                break;
+            }
+
+            if (done == out.size() && remaining != 0) out.resize(out.size() * 2); // Not grown once a frame ends exactly at the end of the output
+
+            ZSTD_outBuffer output{ out.data(), out.size(), done };
+            remaining = ZSTD_decompressStream(stream, &output, &input);
+            if (ZSTD_isError(remaining)) break; // Corrupted data
+
+            done = output.pos;
+        }
+
+        ZSTD_freeDStream(stream);
+        out.resize(done);
+        out.shrink_to_fit(); // Frees what was grown past the content, if the size wasn't known
+        return ok;
+    }
+#endif
+
+    // Decompresses a file chunk by chunk, without ever holding the whole compressed file.
+    // 'gzipTrailer' is the last 4 bytes of a gzip file: the size of its (last) member, used to size the output once.
+    template<typename Read>
+    static bool decompress(Compression compression, Read&& readChunk, std::string& out, uint64_t compressedSize, const unsigned char* gzipTrailer) {
+#ifdef K4INIREADER_ZLIB
+        if (compression == Compression::Gzip) {
+            uint64_t size = gzipTrailer ? (uint64_t(gzipTrailer[0]) | uint64_t(gzipTrailer[1]) << 8 | uint64_t(gzipTrailer[2]) << 16 | uint64_t(gzipTrailer[3]) << 24) : 0;
+            return decompressGzip(readChunk, out, size <= plausibleSize(compressedSize) ? static_cast<size_t>(size) : 0);
+        }
+#endif
+#ifdef K4INIREADER_ZSTD
+        if (compression == Compression::Zstd) return decompressZstd(readChunk, out, compressedSize);
+#endif
+        (void)compression;
+        (void)readChunk;
+        (void)out;
+        (void)compressedSize;
+        (void)gzipTrailer;
+        return false;
+    }
+
+    // Reads a whole file into 'out', decompressing it if it's compressed.
+    // On POSIX systems it only takes an open, a fstat, a single pread (for regular files) and a close.
+    // If 'largeValueFile' is given and the content is the regular file as is, the file is kept open in it to read large values later.
+    static bool readFile(const std::string& fileName, std::string& out, LargeValueFile* largeValueFile = nullptr) {
+#ifdef K4INIREADER_POSIX
+        int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+#if defined(K4INIREADER_ZLIB) || defined(K4INIREADER_ZSTD)
+        unsigned char magic[4];
+        ssize_t nMagic = S_ISREG(st.st_mode) ? ::pread(fd, magic, sizeof(magic), 0) : 0;
+        Compression compression = nMagic > 0 ? detectCompression(magic, static_cast<size_t>(nMagic)) : Compression::None;
+
+        if (compression != Compression::None) {
+            unsigned char trailer[4];
+            bool hasTrailer = st.st_size >= 4 && ::pread(fd, trailer, sizeof(trailer), st.st_size - 4) == 4;
+
+            off_t offset = 0;
+            bool decompressed = decompress(compression, [&](char* buffer, size_t size) -> long {
+                ssize_t n;
+                do n = ::pread(fd, buffer, size, offset); while (n < 0 && errno == EINTR);
+                if (n > 0) offset += n;
+                return static_cast<long>(n);
+            }, out, static_cast<uint64_t>(st.st_size), hasTrailer ? trailer : nullptr);
+
+            ::close(fd);
+            return decompressed;
+        }
+#endif
+
+        // Regular files are read in one go; anything else (pipes, /proc files, ...) is read until its end
+        bool regular = S_ISREG(st.st_mode);
+        out.resize(regular ? static_cast<size_t>(st.st_size) : 4096);
+
+        size_t done = 0;
+        for (;;) {
+            if (done == out.size()) {
+                if (regular) break;
+                out.resize(out.size() * 2);
+            }
+
+            ssize_t n = ::pread(fd, out.data() + done, out.size() - done, static_cast<off_t>(done));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && errno == ESPIPE) n = ::read(fd, out.data() + done, out.size() - done); // Not seekable
+            if (n < 0) {
+                ::close(fd);
+                return false;
+            }
+            if (n == 0) break; // End of the file
+
+            done += static_cast<size_t>(n);
+        }
+
+        if (regular && largeValueFile)
+            largeValueFile->fd = fd;
+        else
+            ::close(fd);
+
+        out.resize(done);
+        if (!regular) out.shrink_to_fit(); // Frees what was grown past the end of a pipe's content
+        return true;
+#else
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file.is_open()) return false;
+
+#if defined(K4INIREADER_ZLIB) || defined(K4INIREADER_ZSTD)
+        unsigned char magic[4];
+        file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+        Compression compression = detectCompression(magic, static_cast<size_t>(file.gcount()));
+        file.clear();
+
+        if (compression != Compression::None) {
+            unsigned char trailer[4];
+            file.seekg(0, std::ios::end);
+            uint64_t compressedSize = static_cast<uint64_t>(file.tellg());
+            file.seekg(-4, std::ios::end);
+            bool hasTrailer = compressedSize >= 4 && file.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) && file.gcount() == 4;
+            file.clear();
+            file.seekg(0, std::ios::beg);
+
+            return decompress(compression, [&](char* buffer, size_t size) -> long {
+                file.read(buffer, static_cast<std::streamsize>(size));
+                return file.bad() ? -1 : static_cast<long>(file.gcount());
+            }, out, compressedSize, hasTrailer ? trailer : nullptr);
+        }
+        file.seekg(0, std::ios::beg);
+#endif
+
+        file.seekg(0, std::ios::end);
+        out.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+        file.read(out.data(), out.size());
+        out.resize(static_cast<size_t>(file.gcount()));
+        if (largeValueFile) largeValueFile->fileName = fileName;
+        return true;
+#endif
+    }
+
+    // Returns the offset of the first invalid UTF-8 sequence (overlong, surrogate, out of range or truncated), or npos.
+    // ASCII text is skipped 16 bytes at a time when SSE2 is available.
+    static size_t findInvalidUtf8(std::string_view s) noexcept {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(s.data());
+        size_t i = 0;
+
+        while (i < s.size()) {
+#ifdef K4INIREADER_SSE2
+            if (s.size() - i >= 16 && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i))) == 0) {
+                i += 16;
+                continue;
+            }
+#endif
+            unsigned char c = bytes[i];
+            if (c < 0x80) {
+                i++;
+                continue;
+            }
+
+            size_t length;
+            uint32_t codePoint, minCodePoint;
+            if ((c & 0xE0) == 0xC0) { length = 2; codePoint = c & 0x1F; minCodePoint = 0x80; }
+            else if ((c & 0xF0) == 0xE0) { length = 3; codePoint = c & 0x0F; minCodePoint = 0x800; }
+            else if ((c & 0xF8) == 0xF0) { length = 4; codePoint = c & 0x07; minCodePoint = 0x10000; }
+            else return i; // Continuation byte without a lead byte, or invalid byte
+
+            if (s.size() - i < length) return i; // Truncated sequence
+            for (size_t k = 1; k < length; k++) {
+                if ((bytes[i + k] & 0xC0) != 0x80) return i;
+                codePoint = (codePoint << 6) | (bytes[i + k] & 0x3F);
+            }
+
+            if (codePoint < minCodePoint || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) return i;
+            i += length;
+        }
+
+        return std::string::npos;
+    }
+
+    // Transcodes UTF-16 to UTF-8; unpaired surrogates become U+FFFD.
+    // Returns the offset of the first unpaired surrogate (or of a trailing odd byte), or npos.
+    // ASCII text is converted 8 code units at a time when SSE2 is available.
+    static size_t transcodeUtf16(std::string_view in, bool littleEndian, std::string& out) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(in.data());
+        size_t nUnits = in.size() / 2;
+        size_t invalidOffset = (in.size() % 2) ? in.size() - 1 : std::string::npos;
+
+        auto unitAt = [&](size_t i) -> uint32_t {
+            return littleEndian ? (bytes[2 * i] | (bytes[2 * i + 1] << 8)) : ((bytes[2 * i] << 8) | bytes[2 * i + 1]);
+        };
+
+        out.resize(nUnits + 16); // Exact for ASCII text; grows when other characters need more bytes
+        char* o = out.data();
+
+        for (size_t i = 0; i < nUnits;) {
+            if (static_cast<size_t>(out.data() + out.size() - o) < 16) { // Room for 8 ASCII characters or a code point
+                size_t written = static_cast<size_t>(o - out.data());
+                out.resize(out.size() + out.size() / 2 + 16);
+                o = out.data() + written;
+            }
+
+#ifdef K4INIREADER_SSE2
+            if (nUnits - i >= 8) {
+                __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 2 * i));
+                if (!littleEndian) units = _mm_or_si128(_mm_slli_epi16(units, 8), _mm_srli_epi16(units, 8));
+
+                __m128i nonAscii = _mm_and_si128(units, _mm_set1_epi16(static_cast<short>(0xFF80)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) == 0xFFFF) { // 8 ASCII characters
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(o), _mm_packus_epi16(units, units));
+                    o += 8;
+                    i += 8;
+                    continue;
+                }
+            }
+#endif
+            uint32_t codePoint = unitAt(i++);
+            if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+                uint32_t low = (codePoint <= 0xDBFF && i < nUnits) ? unitAt(i) : 0;
+                if (low >= 0xDC00 && low <= 0xDFFF) { // Surrogate pair
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    i++;
+                }
+                else {
+                    invalidOffset = std::min(invalidOffset, 2 * (i - 1));
+                    codePoint = 0xFFFD;
+                }
+            }
+
+            if (codePoint < 0x80)
+                *o++ = static_cast<char>(codePoint);
+            else if (codePoint < 0x800) {
+                *o++ = static_cast<char>(0xC0 | (codePoint >> 6));
+                *o++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint < 0x10000) {
+                *o++ = static_cast<char>(0xE0 | (codePoint >> 12));
+                *o++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                *o++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else {
+                *o++ = static_cast<char>(0xF0 | (codePoint >> 18));
+                *o++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                *o++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                *o++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+        out.resize(static_cast<size_t>(o - out.data()));
+        return invalidOffset;
+    }
+
+    // Turns the content into UTF-8 without a byte order mark: removes a UTF-8 one, and transcodes UTF-16
+    // (recognized by its byte order mark, or by a zero byte in its first code unit). Then validates it if asked.
+    void normalizeEncoding(std::string& content, bool validate) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(content.data());
+        size_t invalidOffset = std::string::npos;
+
+        if (content.size() >= 2 && ((bytes[0] == 0xFF && bytes[1] == 0xFE) || (bytes[0] == 0xFE && bytes[1] == 0xFF) ||
+            (content.size() % 2 == 0 && (bytes[0] == 0) != (bytes[1] == 0)))) { // UTF-16
+            bool littleEndian = (bytes[0] == 0xFF) || (bytes[0] != 0xFE && bytes[1] == 0);
+            size_t bomSize = (bytes[0] == 0xFF || bytes[0] == 0xFE) ? 2 : 0;
+
+            std::string utf8;
+            invalidOffset = transcodeUtf16(std::string_view(content).substr(bomSize), littleEndian, utf8);
+            if (invalidOffset != std::string::npos) invalidOffset += bomSize;
+
+            content = std::move(utf8);
+            largeValues.reset(); // The content isn't the file as is anymore
+        }
+        else {
+            size_t bomSize = (content.size() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) ? 3 : 0;
+            if (bomSize) {
+                content.erase(0, bomSize);
+                if (largeValues) largeValues->contentOffset = bomSize;
+            }
+
+            if (validate) invalidOffset = findInvalidUtf8(content);
+            if (invalidOffset != std::string::npos) invalidOffset += bomSize;
+        }
+
+        if (validate) encodingErrorOffset = invalidOffset;
+    }
+
+    // Records the byte ranges of every section, without parsing any key
+    template<typename Dialect>
+    void indexSections(std::string&& fileContent, const K4IniOptions& options) {
+        lazyIndex = std::allocate_shared<LazyIndex>(allocator(), allocator());
+        lazyIndex->parseSection = &parseLazySection<Dialect>;
+        lazyIndex->nKeys = options.nKeys;
+        lazyIndex->sections.reserve(options.nSections); // Reserves sections
+
+        std::string& content = lazyIndex->content;
+        content = std::move(fileContent);
+
+        std::string line, name, value;
+        LazySection* currentSection = nullptr; // Keys found before any header belong to the unnamed section
+        size_t bodyStart = 0;
+
+        // Only lines containing an open square bracket can be section headers, so jumps straight from one to the next.
+        // Lines opening a heredoc are visited too, to skip its body; with continuation lines or checks, every line is visited.
+        [[maybe_unused]] DiagnosticSink sink{ content, diagnosticList };
+        size_t nextBracket = content.find('[');
+        size_t nextHeredoc = Dialect::heredocValues ? content.find("<<") : std::string::npos;
+        for (size_t lineStart = 0; lineStart < content.size();) {
+            if constexpr (!Dialect::backslashContinuation && !Dialect::indentedContinuation && !checks<Dialect>) {
+                if (nextBracket < lineStart) nextBracket = content.find('[', lineStart);
+                if (nextHeredoc < lineStart) nextHeredoc = content.find("<<", lineStart);
+
+                size_t pos = std::min(nextBracket, nextHeredoc);
+                if (pos == std::string::npos) break;
+
+                lineStart = content.rfind('\n', pos);
+                lineStart = (lineStart == std::string::npos) ? 0 : lineStart + 1;
+            }
+
+            size_t headerStart = lineStart;
+            LineType type = nextLine<Dialect>(content, lineStart, content.size(), line, name, value, nullptr, checks<Dialect> ? &sink.issue : nullptr);
+            if constexpr (checks<Dialect>) sink.flush(headerStart);
+
+            if (type == LineType::Section) {
+                if (headerStart > bodyStart) { // Closes the body of the previous section
+                    if (!currentSection) currentSection = &lazyIndex->sections[keyOf(std::string_view())];
+                    currentSection->ranges.emplace_back(bodyStart, headerStart);
+                }
+
+                currentSection = &lazyIndex->sections[keyOf(name)];
+                bodyStart = lineStart;
+            }
+        }
+
+        if (bodyStart < content.size()) { // Closes the body of the last section
+            if (!currentSection) currentSection = &lazyIndex->sections[keyOf(std::string_view())];
+            currentSection->ranges.emplace_back(bodyStart, content.size());
+        }
+    }
+
+    // Inserts every (section, key) pair into the key filter
+    void buildKeyFilter(size_t bitsPerKey) {
+        size_t nPairs = 0;
+        for (const auto& [name, section] : data) nPairs += section.size();
+        for (const auto& table : tables) nPairs += table.rowNames.size() * table.tags.size();
+
+        keyFilter.reset(nPairs, bitsPerKey);
+        for (const auto& [name, section] : data)
+            section.forEach([&](std::string_view key, const Value&) { keyFilter.insert(pairHash(hashOf(name), hashOf(key))); });
+
+        for (const auto& table : tables)
+            for (const auto& [key, column] : table.columnIndex)
+                for (size_t row = 0; row < table.rowNames.size(); row++)
+                    if (table.has(column, row))
+                        keyFilter.insert(pairHash(hashOf(table.rowNames[row]), hashOf(key)));
+    }
+
+    // Returns the table storing a section, or nullptr if the section isn't part of any table
+    inline const Table* findTable(std::string_view s) const noexcept {
+        for (const auto& table : tables)
+            if (s.compare(0, table.prefix.size(), table.prefix) == 0) return &table;
+
+        return nullptr;
+    }
+
+    inline Table* findTable(std::string_view s) noexcept {
+        return const_cast<Table*>(static_cast<const K4IniReader*>(this)->findTable(s));
+    }
+
+    // Searches for a section, parsing it first if it's still lazy
+    template<typename Name>
+    inline const Section* findSection(const Name& s) const {
+        if (lazyIndex) {
+            auto sectionIt = lookup(lazyIndex->sections, s);
+            if (sectionIt == lazyIndex->sections.end()) return nullptr; // The section was not found
+
+            LazySection& section = sectionIt->second;
+            std::call_once(section.parsed, [&] { lazyIndex->parseSection(*lazyIndex, section); });
+            return &section.keys;
+        }
+
+        auto sectionIt = lookup(data, s);
+        if (sectionIt == data.end()) return nullptr; // The section was not found
+
+        return &sectionIt->second;
+    }
+
+    static inline K4IniOptions makeOptions(size_t nSections, size_t nKeys) {
+        K4IniOptions options;
+        options.nSections = nSections;
+        options.nKeys = nKeys;
+        return options;
+    }
+
+#ifdef K4INIREADER_POSIX
+    // Searches for a key in the shared memory segment
+    template<typename Name>
+    inline bool findShared(const Name& s, const Name& k, ValueRef& out) const noexcept {
+        const char* base = shared->base;
+        const auto* header = reinterpret_cast<const SharedHeader*>(base);
+        const auto* slots = reinterpret_cast<const SharedSlot*>(base + header->slotsOffset);
+
+        uint64_t h = pairHash(hashOf(s), hashOf(k));
+        uint64_t mask = header->nSlots - 1;
+
+        for (uint64_t i = h & mask;; i = (i + 1) & mask) {
+            const SharedSlot& slot = slots[i];
+            if (slot.kind == Value::Kind::None) return false; // Empty slot: the pair was not found
+
+            if (slot.hash == h && slot.sectionLength == nameOf(s).size() && slot.keyLength == nameOf(k).size() &&
+                std::memcmp(base + slot.sectionOffset, nameOf(s).data(), slot.sectionLength) == 0 &&
+                std::memcmp(base + slot.keyOffset, nameOf(k).data(), slot.keyLength) == 0) {
+                out.text = std::string_view(base + slot.textOffset, slot.textLength);
+                if (slot.kind == Value::Kind::Float) out.floating = slot.floating;
+                else out.integer = slot.integer;
+                out.kind = slot.kind;
+                out.truthy = slot.truthy;
+                return true;
+            }
+        }
+    }
+
+    // Builds the content of a shared memory segment holding all the pairs
+    std::string buildSharedImage() const {
+        size_t nPairs = 0;
+        forEachPair([&](std::string_view, std::string_view, const ValueRef&) { nPairs++; });
+
+        uint64_t nSlots = 2;
+        while (nSlots < nPairs * 2) nSlots <<= 1;
+
+        uint64_t slotsOffset = sizeof(SharedHeader);
+        uint64_t stringsOffset = slotsOffset + nSlots * sizeof(SharedSlot);
+
+        std::vector<SharedSlot> slots(nSlots);
+        std::string strings;
+        std::unordered_map<std::string_view, uint64_t> sectionOffsets; // Every section name is stored once
+
+        auto addString = [&](std::string_view str) {
+            uint64_t offset = stringsOffset + strings.size();
+            strings += str;
+            return offset;
+        };
+
+        forEachPair([&](std::string_view section, std::string_view key, const ValueRef& value) {
+            uint64_t h = pairHash(hashOf(section), hashOf(key));
+
+            uint64_t i = h & (nSlots - 1);
+            while (slots[i].kind != Value::Kind::None) i = (i + 1) & (nSlots - 1);
+
+            auto [sectionIt, inserted] = sectionOffsets.try_emplace(section, 0);
+            if (inserted) sectionIt->second = addString(section);
+
+            SharedSlot& slot = slots[i];
+            slot.hash = h;
+            slot.sectionOffset = sectionIt->second;
+            slot.sectionLength = static_cast<uint32_t>(section.size());
+            slot.keyOffset = addString(key);
+            slot.keyLength = static_cast<uint32_t>(key.size());
+            slot.textOffset = addString(value.text);
+            slot.textLength = value.text.size();
+            slot.integer = value.kind == Value::Kind::Float ? 0 : value.integer;
+            slot.floating = value.kind == Value::Kind::Float ? value.floating : 0;
+            slot.kind = value.kind;
+            slot.truthy = value.truthy;
+        });
+
+        SharedHeader header{ sharedMagic, nSlots, slotsOffset, stringsOffset + strings.size() };
+
+        std::string image(static_cast<size_t>(header.size), '\0');
+        std::memcpy(image.data(), &header, sizeof(header));
+        std::memcpy(image.data() + slotsOffset, slots.data(), slots.size() * sizeof(SharedSlot));
+        std::memcpy(image.data() + stringsOffset, strings.data(), strings.size());
+        return image;
+    }
+
+    // Maps a whole shared memory segment
+    static void* mapSegment(const std::string& name, int flags, size_t& size) {
+        int fd = ::shm_open(name.c_str(), flags, 0644);
+        if (fd < 0) return nullptr;
+
+        struct stat st;
+        if (size == 0) size = (::fstat(fd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+        else if (::ftruncate(fd, static_cast<off_t>(size)) != 0) size = 0;
+
+        void* map = size ? ::mmap(nullptr, size, (flags & O_RDWR) ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (map == MAP_FAILED && (flags & O_EXCL)) ::shm_unlink(name.c_str()); // Created here but couldn't be sized or mapped
+
+        return map == MAP_FAILED ? nullptr : map;
+    }
+#endif
+
+    // Calls 'f(section, key, value)' for each pair of the reader, the value as a ValueRef (lazy sections get parsed, large values get read)
+    template<typename F>
+    void forEachPair(F&& f) const {
+        auto visit = [&](std::string_view section, std::string_view key, ValueRef&& value) {
+            if (!resolve(value)) return; // Skips missing cells and large values that couldn't be read
+
+            value.printText();
+            f(section, key, static_cast<const ValueRef&>(value));
+        };
+
+        for (const auto& [name, section] : data)
+            section.forEach([&](std::string_view key, const Value& value) { visit(name, key, ValueRef(value)); });
+
+        for (const auto& table : tables)
+            for (const auto& [key, column] : table.columnIndex)
+                for (size_t row = 0; row < table.rowNames.size(); row++) {
+                    ValueRef value;
+                    table.cell(column, row, value);
+                    visit(table.rowNames[row], key, std::move(value));
+                }
+
+        if (lazyIndex)
+            for (const auto& [name, lazySection] : lazyIndex->sections)
+                findSection(name)->forEach([&](std::string_view key, const Value& value) { f(name, key, ValueRef(value)); });
+    }
+
+    // Searches for a key in a section.
+    // Returns true if found and stores its value in 'out'.
+    template<typename Name>
+    inline bool find(const Name& s, const Name& k, ValueRef& out) const noexcept {
+#ifdef K4INIREADER_POSIX
+        if (shared) return findShared(s, k, out);
+#endif
+
+        if (!keyFilter.empty() && !keyFilter.mayContain(pairHash(hashOf(s), hashOf(k)))) return false; // The pair is certainly missing
+
+        if (const Table* table = findTable(nameOf(s))) {
+            auto rowIt = lookup(table->rowIndex, s);
+            if (rowIt == table->rowIndex.end()) return false; // The section was not found
+
+            if (!table->find(rowIt->second, k, out)) return false; // The key was not found
+        }
+        else {
+            const Section* section = findSection(s);
+            if (!section) return false; // The section was not found
+
+            const Value* value = section->find(k);
+            if (!value) return false; // The key was not found
+
+            out = *value; // Get the value
+        }
+
+        return resolve(out); // False for a large value that couldn't be read
+    }
+
+    // Extracts all the sections, keys, and their values from the content of a .ini file
+    template<typename Dialect>
+    void load(std::string&& content, const K4IniOptions& options) {
+        opened = true;
+        normalizeEncoding(content, options.validateUtf8);
+
+        if (options.lazy) { // Sections will be parsed on their first read
+            indexSections<Dialect>(std::move(content), options);
+            return;
+        }
+
+        data.reserve(options.nSections); // Reserves sections
+
+        tables.reserve(options.tables.size());
+        for (const auto& prefix : options.tables) tables.emplace_back(prefix);
+
+        std::string line, name, value;
+        Section* currentSection = nullptr; // Keys found before any header belong to the unnamed section
+        Table* currentTable = nullptr;     // Set while the current section is a row of a table
+        size_t currentRow = 0;
+        size_t valueOffset = std::string::npos; // Where the value is in the content, if large values are left in the file
+        [[maybe_unused]] DiagnosticSink sink{ content, diagnosticList };
+
+        for (size_t lineStart = 0; lineStart < content.size();) {
+            [[maybe_unused]] size_t start = lineStart;
+            LineType type = nextLine<Dialect>(content, lineStart, content.size(), line, name, value,
+                largeValues ? &valueOffset : nullptr, checks<Dialect> ? &sink.issue : nullptr);
+            if constexpr (checks<Dialect>) sink.flush(start);
+
+            switch (type) {
+            case LineType::Section:
+                // Any key read from now on will be part of the section extracted (until a new section is found)
+                currentTable = findTable(name);
+                if (currentTable)
+                    currentRow = currentTable->addRow(name);
+                else {
+                    currentSection = &data[keyOf(name)];
+                    currentSection->reserve(options.nKeys); // Reserve keys for this section
+                }
+                break;
+            case LineType::KeyValue: {
+                Value v = (largeValues && value.size() > options.largeValueBytes) ?
+                    makeLargeValue(value, valueOffset, content) : makeValue(value, allocator());
+
+                if (currentTable)
+                    currentTable->set(currentRow, name, std::move(v)); // Inserts the value into the key's column
+                else {
+                    if (!currentSection) currentSection = &data[keyOf(std::string_view())];
+                    currentSection->set(name, std::move(v)); // Inserts the key-value pair into the current section
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        for (auto& [name, section] : data) section.shrink();
+        for (auto& table : tables) table.shrink();
+
+        if (options.filterBitsPerKey) buildKeyFilter(options.filterBitsPerKey);
+    }
+
+    K4IniReader() = default;
+
+    // Reader whose storage is allocated from 'resource'
+    explicit K4IniReader(std::pmr::memory_resource* resource) : data(resource), keyFilter(resource), tables(resource) {}
+
+    static inline std::pmr::memory_resource* resourceOf(const K4IniOptions& options) noexcept {
+        return options.memoryResource ? options.memoryResource : std::pmr::get_default_resource();
+    }
+
+    friend class K4IniBulkLoader;
+
+    template<size_t, size_t, size_t, typename>
+    friend class K4IniFixedReader;
+
+public:
+    // Extracts all the sections, keys, and their values from a .ini file
+    K4IniReader(const std::string& fileName, size_t nSections = 32, size_t nKeys = 8)
+        : K4IniReader(fileName, makeOptions(nSections, nKeys)) {}
+
+    // Extracts all the sections, keys, and their values from a .ini file, using the given options
+    // and the parsing rules of the given dialect (see K4IniDialect)
+    template<typename Dialect = K4IniDialect>
+    K4IniReader(const std::string& fileName, const K4IniOptions& options, Dialect = Dialect()) : K4IniReader(resourceOf(options)) {
+        std::string content;
+        std::shared_ptr<LargeValueFile> largeValueFile;
+        if (options.largeValueBytes && !options.lazy) largeValueFile = std::allocate_shared<LargeValueFile>(allocator(), allocator());
+
+        if (!readFile(fileName, content, largeValueFile.get())) { // Don't 
+            if constexpr (checks<Dialect>) diagnosticList.push_back({ 0, 0, "can't open the file" });
+            if constexpr (Dialect::strict) throw K4IniParseError(fileName, diagnosticList);
+            return;
+        }
+
+        if (largeValueFile && largeValueFile->isOpen()) largeValues = std::move(largeValueFile);
+        load<Dialect>(std::move(content), options);
+
+        if constexpr (Dialect::strict) {
+            if (!diagnosticList.empty()) throw K4IniParseError(fileName, std::move(diagnosticList));
+        }
+    }
+
+    // Extracts all the sections, keys, and their values from the content of a .ini file already in memory
+    template<typename Dialect = K4IniDialect>
+    static K4IniReader fromString(std::string content, const K4IniOptions& options = K4IniOptions(), Dialect = Dialect()) {
+        K4IniReader reader(resourceOf(options));
+        reader.load<Dialect>(std::move(content), options);
+
+        if constexpr (Dialect::strict) {
+            if (!reader.diagnosticList.empty()) throw K4IniParseError("<string>", std::move(reader.diagnosticList));
+        }
+        return reader;
+    }
+
+#ifdef K4INIREADER_POSIX
+    // Publishes all the pairs of the reader in the POSIX shared memory segment '<name>.<generation>' (e.g. name = "/config"),
+    // so that other processes can attach to it without parsing the file.
+    // Publishing again creates a new generation; readers attached to the previous one keep working until they attach again.
+    bool publish(const std::string& name) const {
+        std::string image = buildSharedImage();
+
+        size_t controlSize = sizeof(SharedControl);
+        auto* control = static_cast<SharedControl*>(mapSegment(name, O_RDWR | O_CREAT, controlSize));
+        if (!control) return false;
+
+        // Claims are kept past the published generation, even if 'claimed' was lost (e.g. a control segment written by an older version)
+        uint64_t published = control->generation.load(std::memory_order_acquire);
+        uint64_t claimed = control->claimed.load(std::memory_order_acquire);
+        while (claimed < published && !control->claimed.compare_exchange_weak(claimed, published, std::memory_order_acq_rel)) {}
+
+        // A new segment only: one that already exists may be mapped by attached readers, and resizing it would make them fault.
+        // A segment left by a previous control segment (removed and created again) takes the name: the next generation is claimed then.
+        uint64_t generation;
+        std::string segmentName;
+        size_t size;
+        void* segment;
+        do {
+            generation = control->claimed.fetch_add(1, std::memory_order_acq_rel) + 1;
+            segmentName = name + '.' + std::to_string(generation);
+            size = image.size();
+            segment = mapSegment(segmentName, O_RDWR | O_CREAT | O_EXCL, size);
+        } while (!segment && errno == EEXIST);
+
+        if (segment) {
+            std::memcpy(segment, image.data(), image.size());
+            ::munmap(segment, size);
+
+            // Publishes the generation, unless a concurrent publisher already published a newer one
+            uint64_t previous = control->generation.load(std::memory_order_acquire);
+            while (previous < generation && !control->generation.compare_exchange_weak(previous, generation, std::memory_order_acq_rel)) {}
+
+            if (previous < generation) {
+                if (previous > 0) ::shm_unlink((name + '.' + std::to_string(previous)).c_str()); // Mapped by attached readers until they let it go
+            }
+            else ::shm_unlink(segmentName.c_str()); // Superseded before being published
+        }
+
+        ::munmap(control, sizeof(SharedControl));
+        return segment != nullptr;
+    }
+
+    // Attaches to the latest generation published with 'publish'.
+    // The reader maps the segment read-only and reads it in place; if nothing was published, isOpen() returns false.
+    static K4IniReader attach(const std::string& name) {
+        K4IniReader reader;
+        auto mapping = std::make_shared<SharedMapping>();
+
+        size_t controlSize = 0;
+        mapping->control = static_cast<const SharedControl*>(mapSegment(name, O_RDONLY, controlSize));
+        if (!mapping->control || controlSize < sizeof(SharedControl)) return reader;
+
+        for (int attempt = 0; attempt < 8 && !mapping->base; attempt++) { // Retries if a new generation replaces the one being opened
+            mapping->generation = mapping->control->generation.load(std::memory_order_acquire);
+            if (mapping->generation == 0) return reader; // Nothing published yet
+
+            mapping->size = 0;
+            mapping->base = static_cast<const char*>(mapSegment(name + '.' + std::to_string(mapping->generation), O_RDONLY, mapping->size));
+        }
+
+        if (!mapping->base) return reader;
+
+        const auto* header = reinterpret_cast<const SharedHeader*>(mapping->base);
+        if (mapping->size < sizeof(SharedHeader) || header->magic != sharedMagic || header->size > mapping->size ||
+            header->slotsOffset + header->nSlots * sizeof(SharedSlot) > mapping->size)
+            return reader; // Not a segment published by K4IniReader
+
+        reader.shared = std::move(mapping);
+        reader.opened = true;
+        return reader;
+    }
+
+    // Returns whether an attached reader's segment was replaced by a newer generation
+    bool isStale() const noexcept {
+        return shared && shared->control->generation.load(std::memory_order_acquire) != shared->generation;
+    }
+#endif
+
+#ifdef K4INIREADER_COROUTINES
+    // Reads and parses a .ini file on another thread (C++20: awaitable)
+    static K4IniAsyncLoad loadAsync(const std::string& fileName, const K4IniOptions& options = K4IniOptions());
+
+    // Same, but the awaiting coroutine is handed to 'post' (called on the loading thread), which resumes it where it wants,
+    // e.g. by queueing it to the caller's event loop
+    static K4IniAsyncLoad loadAsync(const std::string& fileName, const K4IniOptions& options, std::function<void(std::coroutine_handle<>)> post);
+#else
+    // Reads and parses a .ini file on another thread
+    static std::future<K4IniReader> loadAsync(const std::string& fileName, const K4IniOptions& options = K4IniOptions()) {
+        return std::async(std::launch::async, [fileName, options] { return K4IniReader(fileName, options); });
+    }
+#endif
+
+private:
+    // Whether K4IniConvert<T> has a 'parse' function (i.e. T can be read)
+    template<typename T, typename = void>
+    struct Convertible : std::false_type {};
 
-    // Removes leading and trailing whitespaces from a string
-    static inline void trim(std::string& s) noexcept {
-        // Trim from start
-        s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch) { return !std::isspace(ch); }));
+    template<typename T>
+    struct Convertible<T, std::void_t<decltype(K4IniConvert<T>::parse(std::declval<std::string_view>(), std::declval<T&>()))>> : std::true_type {};
 
-        // Trim from end
-        s.erase(std::find_if(s.rbegin(), s.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), s.end());
+    // Returns whether a value is one of the boolean words ("true", "1", "on", "yes" and "false", "0", "off", "no")
+    static inline bool isBoolToken(ValueRef& value) noexcept {
+        if (value.kind == Value::Kind::Bool) return true;
+
+        value.printText();
+        return value.text == "1" || value.text == "0";
     }
 
-    // Removes any inline comments from a string.
-    // Supports comment markers: "//", ";", and "#". 
-    // If multiple markers are present, removes from the first one found.
-    static inline void removeInlineComment(std::string& s) noexcept {
-        size_t commaOrHashtagPos = s.find_first_of(";#");
-        size_t doubleSlashPos = s.find("//");
+    // Returns whether the whole text is a number of type T (even one out of its range)
+    template<typename T>
+    static inline bool isWholeNumber(std::string_view text) noexcept {
+        T number{};
+        auto result = std::from_chars(text.data(), text.data() + text.size(), number);
+        return result.ec != std::errc::invalid_argument && result.ptr == text.data() + text.size();
+    }
 
-        if (commaOrHashtagPos != std::string::npos) {
-            if (doubleSlashPos != std::string::npos)
-                s.erase(std::min(commaOrHashtagPos, doubleSlashPos));
-            else
-                s.erase(commaOrHashtagPos);
+    // Converts a value to T into 'out', which is left untouched unless the status returned is Ok.
+    // If 'exact' is set, booleans must be one of the boolean words and numbers must take the whole value;
+    // otherwise anything else reads as false and a number only has to start the value (like 'read' always did).
+    template<typename T>
+    static K4IniStatus convertTo(ValueRef* value, T& out, bool toLowerString, bool exact = false) noexcept {
+        if (!value) return K4IniStatus::Missing;
+
+        if constexpr (std::is_same_v<T, bool>) { // If T is a boolean
+            if (exact && !isBoolToken(*value)) return K4IniStatus::Unparsable;
+
+            out = value->truthy;
+            return K4IniStatus::Ok;
         }
+
+        // Uses the number converted at load, if the value is entirely a number of the same family
+        else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, char>) {
+            if (value->kind == Value::Kind::Integer) {
+                if constexpr (std::is_unsigned_v<T>) {
+                    // A text printed back only starts with '-' for a negative number; one kept may be "-0"
+                    if (value->integer < 0 || (!value->textPending && value->text[0] == '-') || static_cast<unsigned long long>(value->integer) > std::numeric_limits<T>::max())
+                        return K4IniStatus::OutOfRange;
+                }
+                else if (value->integer < std::numeric_limits<T>::min() || value->integer > std::numeric_limits<T>::max())
+                    return K4IniStatus::OutOfRange;
+
+                out = static_cast<T>(value->integer);
+                return K4IniStatus::Ok;
+            }
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            if (value->kind == Value::Kind::Integer) {
+                out = static_cast<double>(value->integer); // Rounded to the nearest double, like from_chars does
+                return K4IniStatus::Ok;
+            }
+            if (value->kind == Value::Kind::Float) {
+                out = value->floating;
+                return K4IniStatus::Ok;
+            }
+        }
+
+        if constexpr (!Convertible<T>::value) return K4IniStatus::Unparsable; // Unhandled types
         else {
-            if (doubleSlashPos != std::string::npos)
-                s.erase(doubleSlashPos);
+            value->printText();
+
+            if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+                if (exact && !isWholeNumber<T>(value->text)) return K4IniStatus::Unparsable; // e.g. "42abc" or "2.5" read as an integer
+
+            K4IniStatus status;
+            auto result = K4IniConvert<T>::parse(value->text, out);
+            if constexpr (std::is_same_v<decltype(result), bool>) status = result ? K4IniStatus::Ok : K4IniStatus::Unparsable;
+            else status = result;
+
+            if constexpr (std::is_same_v<T, std::string>)
+                if (status == K4IniStatus::Ok && toLowerString) toLowerAscii(out); // Only ASCII letters are lowered, whatever the C locale
+
+            return status;
         }
     }
 
-    // Searches for a key in a section.
-    // Returns true if found and stores its value in 'out'.
-    inline bool find(const std::string& s, const std::string& k, std::string& out) const noexcept {
-        auto sectionIt = data.find(s);
-        if (sectionIt == data.end()) return false; // The section was not found
+    // Converts a value to T, returning the default value if it's missing or can't be converted
+    template<typename T>
+    static T convert(ValueRef* value, T defaultValue, bool toLowerString) noexcept {
+        convertTo(value, defaultValue, toLowerString); // Keeps the default value if it fails
+        return defaultValue;
+    }
+
+public:
+    // Returns whether the file could be opened; if not, every read returns the default value
+    inline bool isOpen() const noexcept { return opened; }
+
+    // Returns the byte offset in the file of the first invalid UTF-8 sequence (or unpaired UTF-16 surrogate),
+    // or npos if the content is valid; always npos unless 'validateUtf8' was set
+    inline size_t invalidUtf8Offset() const noexcept { return encodingErrorOffset; }
+
+    // Returns the problems found while loading (malformed lines, file that can't be opened),
+    // with a dialect collecting them (K4IniDiagnostics or K4IniStrict); always empty otherwise
+    inline const std::vector<K4IniDiagnostic>& diagnostics() const noexcept { return diagnosticList; }
+
+    // Converts a string to T the same way 'read' converts the values found
+    template<typename T>
+    static T parse(std::string_view text, T defaultValue, bool toLowerString = false) noexcept {
+        ValueRef value;
+        value.text = text;
+        if constexpr (std::is_arithmetic_v<T>) classify(text, value); // Only numbers and booleans use the conversion done at load
+        return convert(&value, defaultValue, toLowerString);
+    }
+
+    // Calls 'f(section, key, value)' for every key-value pair, all passed as std::string_view (lazy sections get parsed)
+    template<typename F>
+    void forEach(F&& f) const {
+#ifdef K4INIREADER_POSIX
+        if (shared) {
+            const char* base = shared->base;
+            const auto* header = reinterpret_cast<const SharedHeader*>(base);
+            const auto* slots = reinterpret_cast<const SharedSlot*>(base + header->slotsOffset);
+
+            for (uint64_t i = 0; i < header->nSlots; i++)
+                if (slots[i].kind != Value::Kind::None)
+                    f(std::string_view(base + slots[i].sectionOffset, slots[i].sectionLength), std::string_view(base + slots[i].keyOffset, slots[i].keyLength),
+                      std::string_view(base + slots[i].textOffset, slots[i].textLength));
+            return;
+        }
+#endif
+
+        forEachPair([&](std::string_view section, std::string_view key, const ValueRef& value) {
+            f(section, key, value.text);
+        });
+    }
+
+    // Reads a value of a key from a section
+    template<typename T>
+    T read(const std::string& section, const std::string& key, T defaultValue, bool toLowerString = false) const noexcept {
+        ValueRef value;
+        return convert(find(section, key, value) ? &value : nullptr, defaultValue, toLowerString);
+    }
+
+    // Reads a value of a key from a section, using names hashed at compile time (e.g. "Graphics"_sec, "v-sync"_key)
+    template<typename T>
+    T read(const K4IniKey& section, const K4IniKey& key, T defaultValue, bool toLowerString = false) const noexcept {
+        ValueRef value;
+        return convert(find(section, key, value) ? &value : nullptr, defaultValue, toLowerString);
+    }
+
+    // Reads a value of a key from a section, or std::nullopt where 'read' would return the default value.
+    // Unlike calling 'read' with two different defaults, it only looks the key up once.
+    template<typename T>
+    std::optional<T> tryRead(const std::string& section, const std::string& key, bool toLowerString = false) const noexcept {
+        ValueRef value;
+        T out{};
+        if (!find(section, key, value) || convertTo(&value, out, toLowerString, true) != K4IniStatus::Ok) return std::nullopt;
+        return out;
+    }
 
-        auto keyIt = sectionIt->second.find(k);
-        if (keyIt == sectionIt->second.end()) return false; // The key was not found
+    template<typename T>
+    std::optional<T> tryRead(const K4IniKey& section, const K4IniKey& key, bool toLowerString = false) const noexcept {
+        ValueRef value;
+        T out{};
+        if (!find(section, key, value) || convertTo(&value, out, toLowerString, true) != K4IniStatus::Ok) return std::nullopt;
+        return out;
+    }
+
+    // Reads a value of a key from a section, telling why it couldn't be read (missing, unparsable or out of range)
+    template<typename T>
+    K4IniResult<T> readResult(const std::string& section, const std::string& key, bool toLowerString = false) const noexcept {
+        ValueRef value;
+        K4IniResult<T> result;
+        result.status = convertTo(find(section, key, value) ? &value : nullptr, result.value, toLowerString, true);
+        return result;
+    }
+
+    template<typename T>
+    K4IniResult<T> readResult(const K4IniKey& section, const K4IniKey& key, bool toLowerString = false) const noexcept {
+        ValueRef value;
+        K4IniResult<T> result;
+        result.status = convertTo(find(section, key, value) ? &value : nullptr, result.value, toLowerString, true);
+        return result;
+    }
+
+    // Reads a key from every section of a table, in the order the sections appear in the file.
+    // Sections missing the key get the default value.
+    template<typename T>
+    std::vector<T> readColumn(const std::string& table, const std::string& key, T defaultValue, bool toLowerString = false) const {
+        std::vector<T> out;
+
+        for (const auto& t : tables) {
+            if (std::string_view(t.prefix) != table) continue;
+
+            auto columnIt = lookup(t.columnIndex, key);
+            if (columnIt == t.columnIndex.end()) return std::vector<T>(t.rowNames.size(), defaultValue); // The key was not found
+
+            out.reserve(t.rowNames.size());
+            for (size_t row = 0; row < t.rowNames.size(); row++) {
+                ValueRef value;
+                t.cell(columnIt->second, row, value);
+                out.push_back(convert(resolve(value) ? &value : nullptr, defaultValue, toLowerString));
+            }
+            break;
+        }
+
+        return out;
+    }
+
+    // Returns the names of the sections stored in a table, in the order they appear in the file
+    std::vector<std::string> tableRows(const std::string& table) const {
+        for (const auto& t : tables)
+            if (std::string_view(t.prefix) == table) return std::vector<std::string>(t.rowNames.begin(), t.rowNames.end());
+
+        return {};
+    }
+};
+
+#ifdef K4INIREADER_COROUTINES
+// Reader being loaded on another thread; 'co_await' it to get the reader.
+// The awaiting coroutine is resumed on the loading thread, unless a 'post' function was given to resume it elsewhere.
+class K4IniAsyncLoad {
+private:
+    struct State {
+        std::mutex mutex;
+        std::optional<K4IniReader> reader;
+        std::exception_ptr error;
+        std::coroutine_handle<> waiter; // Coroutine to resume once the reader is ready
+        bool done = false;
+    };
+
+    std::shared_ptr<State> state;
+
+public:
+    K4IniAsyncLoad(const std::string& fileName, const K4IniOptions& options, std::function<void(std::coroutine_handle<>)> post = nullptr)
+        : state(std::make_shared<State>()) {
+        std::thread([state = state, fileName, options, post = std::move(post)] {
+            std::optional<K4IniReader> reader;
+            std::exception_ptr error;
+            try {
+                reader.emplace(fileName, options);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            std::coroutine_handle<> waiter;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->reader = std::move(reader);
+                state->error = error;
+                state->done = true;
+                waiter = state->waiter;
+            }
+
+            if (!waiter) return;
+            if (post) post(waiter);
+            else waiter.resume();
+        }).detach();
+    }
+
+    bool await_ready() const noexcept {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->done;
+    }
 
-        out = keyIt->second; // Get the value
+    // Suspends the coroutine, unless the reader got ready in the meantime
+    bool await_suspend(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->done) return false;
 
+        state->waiter = handle;
         return true;
     }
 
+    K4IniReader await_resume() {
+        if (state->error) std::rethrow_exception(state->error);
+        return std::move(*state->reader);
+    }
+};
+
+inline K4IniAsyncLoad K4IniReader::loadAsync(const std::string& fileName, const K4IniOptions& options) {
+    return K4IniAsyncLoad(fileName, options);
+}
+
+inline K4IniAsyncLoad K4IniReader::loadAsync(const std::string& fileName, const K4IniOptions& options, std::function<void(std::coroutine_handle<>)> post) {
+    return K4IniAsyncLoad(fileName, options, std::move(post));
+}
+#endif
+
+// Process-wide cache of readers, so that components loading the same file share a single parsed copy.
+// A file is identified by its canonical path, modification time, size and inode: once it's edited, it's loaded again.
+class K4IniRegistry {
+private:
+    using ReaderPtr = std::shared_ptr<const K4IniReader>;
+
+    struct Entry {
+        std::string identity;                    // Modification time, size and inode of the file loaded
+        std::shared_future<ReaderPtr> reader;    // Ready once the file is parsed; shared by concurrent loads of the same file
+        size_t cost = 0;                         // Size of the file, set once it's parsed
+        std::list<std::string>::iterator lruIt; // Position in 'lru'
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries; // Canonical path and options -> entry
+    std::list<std::string> lru;                      // Keys of the entries, most recently used first
+    size_t memoryBudget = std::numeric_limits<size_t>::max();
+    size_t memoryUsed = 0;
+
+    // Part of the key depending on the options that change the content of a reader
+    static std::string optionsKey(const K4IniOptions& options) {
+        std::string key = options.lazy ? "L" : "E";
+        key += std::to_string(options.filterBitsPerKey);
+        key += '/';
+        key += std::to_string(options.largeValueBytes);
+        key += options.validateUtf8 ? "V" : "";
+        key += '@';
+        key += std::to_string(reinterpret_cast<uintptr_t>(options.memoryResource)); // Readers are only shared if they use the same resource
+        for (const auto& prefix : options.tables) {
+            key += '\0';
+            key += prefix;
+        }
+
+        return key;
+    }
+
+    // Returns the modification time, size and inode of a file, or an empty string if it can't be read
+    static std::string fileIdentity(const std::filesystem::path& path, size_t& size) {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        if (ec) return {};
+
+        size = static_cast<size_t>(std::filesystem::file_size(path, ec));
+        if (ec) return {};
+
+        std::string identity = std::to_string(mtime.time_since_epoch().count()) + ':' + std::to_string(size);
+
+#ifndef _WIN32
+        struct stat st;
+        if (::stat(path.c_str(), &st) == 0)
+            identity += ':' + std::to_string(st.st_dev) + ':' + std::to_string(st.st_ino);
+#endif
+
+        return identity;
+    }
+
+    // Drops the least recently used entries until the budget is respected, keeping the given one
+    void evict(const std::string& keep) {
+        for (auto it = lru.end(); memoryUsed > memoryBudget && it != lru.begin();) {
+            --it;
+
+            auto entryIt = entries.find(*it);
+            if (*it == keep || entryIt->second.cost == 0) continue; // Keeps the entries still loading
+
+            memoryUsed -= entryIt->second.cost;
+            entries.erase(entryIt);
+            it = lru.erase(it);
+        }
+    }
+
 public:
-    // Extracts all the sections, keys, and their values from a .ini file
-    K4IniReader(const std::string& fileName, size_t nSections = 32, size_t nKeys = 8) {
-        std::ifstream file(fileName);
-        if (!file.is_open()) return; // Don't 
+    // Registry shared by the whole process
+    static K4IniRegistry& instance() {
+        static K4IniRegistry registry;
+        return registry;
+    }
+
+    // Returns the reader of a file, parsing it only if it isn't cached or if it changed since it was cached.
+    // Concurrent calls for the same file wait for a single parse.
+    ReaderPtr get(const std::string& fileName, const K4IniOptions& options = K4IniOptions()) {
+        std::error_code ec;
+        size_t size = 0;
+        std::filesystem::path path = std::filesystem::canonical(fileName, ec);
+        std::string identity = ec ? std::string() : fileIdentity(path, size);
+        if (identity.empty()) return std::make_shared<const K4IniReader>(fileName, options); // The file can't be read, nothing to cache
+
+        std::string key = path.string() + '\0' + optionsKey(options);
+
+        std::shared_future<ReaderPtr> cached;
+        std::promise<ReaderPtr> promise;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            auto entryIt = entries.find(key);
+            if (entryIt != entries.end() && entryIt->second.identity == identity) { // Cached or being loaded
+                lru.splice(lru.begin(), lru, entryIt->second.lruIt);
+                cached = entryIt->second.reader;
+            }
+            else {
+                if (entryIt != entries.end()) { // The file changed: the old reader stays valid for whoever still holds it
+                    memoryUsed -= entryIt->second.cost;
+                    lru.erase(entryIt->second.lruIt);
+                    entries.erase(entryIt);
+                }
+
+                lru.push_front(key);
+                Entry& entry = entries[key];
+                entry.identity = identity;
+                entry.reader = promise.get_future().share();
+                entry.lruIt = lru.begin();
+            }
+        }
+
+        if (cached.valid()) return cached.get(); // Waits if another thread is still parsing the file
+
+        ReaderPtr reader;
+        try {
+            reader = std::make_shared<const K4IniReader>(path.string(), options);
+        }
+        catch (...) {
+            promise.set_exception(std::current_exception());
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto entryIt = entries.find(key);
+            if (entryIt != entries.end() && entryIt->second.identity == identity && entryIt->second.cost == 0) {
+                lru.erase(entryIt->second.lruIt);
+                entries.erase(entryIt);
+            }
+            throw;
+        }
+
+        promise.set_value(reader);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto entryIt = entries.find(key);
+        if (entryIt != entries.end() && entryIt->second.identity == identity && entryIt->second.cost == 0) {
+            entryIt->second.cost = std::max<size_t>(1, size);
+            memoryUsed += entryIt->second.cost;
+            evict(key);
+        }
+
+        return reader;
+    }
+
+    // Sets the maximum total size of the files cached; the least recently used readers are dropped past it.
+    // Readers dropped stay valid for whoever still holds them.
+    void setMemoryBudget(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        memoryBudget = bytes;
+        evict({});
+    }
+
+    // Drops all the cached readers
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        lru.clear();
+        memoryUsed = 0;
+    }
+};
+
+// Readers and errors of the files loaded by K4IniBulkLoader
+struct K4IniBulkResult {
+    std::unordered_map<std::string, std::shared_ptr<const K4IniReader>> readers; // File name -> reader
+    std::unordered_map<std::string, std::string> errors;                         // File name -> error, for the files that couldn't be loaded
+};
+
+// Pattern selecting the files loaded by K4IniBulkLoader::loadDirectory.
+// '*' matches any characters but '/', '?' any one character but '/', and '**' any number of directories.
+// Without a '/', the pattern is matched against the file names (e.g. "dev*.ini");
+// otherwise it's matched against the paths relative to the directory (e.g. "site?/**/*.ini").
+struct K4IniGlob {
+    std::string pattern;
+
+    explicit K4IniGlob(std::string pattern) : pattern(std::move(pattern)) {}
+
+    bool matches(std::string_view path) const noexcept {
+        return match(pattern, path);
+    }
+
+private:
+    static bool match(std::string_view pattern, std::string_view text) noexcept {
+        while (!pattern.empty()) {
+            if (pattern[0] == '*') {
+                bool anyDirectory = pattern.size() > 1 && pattern[1] == '*';
+                size_t stars = pattern.find_first_not_of('*');
+                pattern.remove_prefix(stars == std::string_view::npos ? pattern.size() : stars);
+                if (anyDirectory && !pattern.empty() && pattern[0] == '/' && match(pattern.substr(1), text)) return true; // "**/" matching no directory
+
+                // Tries every length for the star, stopping at a '/' unless it's "**"
+                for (size_t i = 0;; i++) {
+                    if (match(pattern, text.substr(i))) return true;
+                    if (i == text.size() || (!anyDirectory && text[i] == '/')) return false;
+                }
+            }
+
+            if (text.empty() || (pattern[0] == '?' ? text[0] == '/' : pattern[0] != text[0])) return false;
+            pattern.remove_prefix(1);
+            text.remove_prefix(1);
+        }
+        return text.empty();
+    }
+};
+
+// Loads many .ini files concurrently.
+// Errors are collected per file instead of being thrown.
+class K4IniBulkLoader {
+private:
+    static constexpr unsigned ioThreadsPerCore = 4; // Reading is latency-bound, so more reads than cores are kept in flight
+
+    // Calls 'f(i)' for every i in [0, n) on 'nThreads' threads (including the calling one).
+    // Every thread claims the next index as soon as it's done with the previous one, so slow files don't stall the others.
+    template<typename F>
+    static void parallelFor(size_t n, unsigned nThreads, F&& f) {
+        if (nThreads == 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
+        nThreads = static_cast<unsigned>(std::min<size_t>(nThreads, n));
 
-        data.reserve(nSections); // Reserves sections
+        std::atomic<size_t> next{ 0 };
+        auto work = [&] {
+            for (size_t i = next++; i < n; i = next++) f(i);
+        };
 
-        std::string line;
-        std::string currentSection;
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < nThreads; t++) threads.emplace_back(work);
+        work();
 
-        while (std::getline(file, line)) {
-            removeInlineComment(line); // Removes inline comments before processing the line
+        for (auto& thread : threads) thread.join();
+    }
+
+    // Loads every file of a directory and its subdirectories for which 'select(entry)' returns true
+    template<typename F>
+    static K4IniBulkResult loadSelected(const std::string& directory, F&& select, const K4IniOptions& options, unsigned nThreads) {
+        std::vector<std::string> fileNames;
+        std::error_code ec;
+
+        for (std::filesystem::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+            if (it->is_regular_file(ec) && select(*it))
+                fileNames.push_back(it->path().string());
+
+        K4IniBulkResult result = load(fileNames, options, nThreads);
+        if (ec) result.errors[directory] = ec.message(); // The directory couldn't be fully listed
 
-            if (line.empty()) continue; // Skips empty lines
+        return result;
+    }
 
-            size_t posBracketStart = line.find('['); // Finds the position of the open square bracket
-            size_t posEqualSing = line.find('=');    // Finds the position of the equal sign
+public:
+    // Loads a list of files.
+    // All the files are read first, with many reads in flight at once, then the buffers read are parsed.
+    // 'nThreads' is the number of threads parsing the files (0 means one per hardware thread).
+    static K4IniBulkResult load(const std::vector<std::string>& fileNames, const K4IniOptions& options = K4IniOptions(), unsigned nThreads = 0) {
+        std::vector<std::shared_ptr<const K4IniReader>> readers(fileNames.size());
+        std::vector<std::string> contents(fileNames.size());
+        std::vector<std::string> errors(fileNames.size());
 
-            if (posBracketStart != std::string::npos) { // If there is an open square bracket, checks if further ahead there's a close one.
-                size_t posBracketEnd = line.find(']', posBracketStart);
-                if (posBracketEnd == std::string::npos) continue; // If it wasn't found, skips to the next line
+        if (nThreads == 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
 
-                std::string sectionExtracted = line.substr(posBracketStart + 1, posBracketEnd - posBracketStart - 1); // Extract the content between the two brackets
-                trim(sectionExtracted); // Remove leading and trailing whitespaces
-                currentSection = sectionExtracted; // Any key read from now on will be part of the section extracted (until a new section is found)
-                data[currentSection].reserve(nKeys); // Reserve keys for this section
+        parallelFor(fileNames.size(), nThreads * ioThreadsPerCore, [&](size_t i) {
+            try {
+                if (!K4IniReader::readFile(fileNames[i], contents[i])) errors[i] = "can't open the file";
             }
-            else if (posEqualSing != std::string::npos) { // If there's an equal sign
-                std::string keyExtracted = line.substr(0, posEqualSing); // Extracts the key
-                trim(keyExtracted); // Removes leading and trailing whitespaces
+            catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        });
 
-                std::string value = line.substr(posEqualSing + 1); // Extracts the value
-                trim(value); // Removes leading and trailing whitespaces
+        parallelFor(fileNames.size(), nThreads, [&](size_t i) {
+            if (!errors[i].empty()) return;
 
-                data[currentSection][keyExtracted] = value; // Inserts the key-value pair into the current section
+            try {
+                readers[i] = std::make_shared<const K4IniReader>(K4IniReader::fromString(std::move(contents[i]), options));
+            }
+            catch (const std::exception& e) {
+                errors[i] = e.what();
             }
+        });
+
+        K4IniBulkResult result;
+        result.readers.reserve(fileNames.size());
+        for (size_t i = 0; i < fileNames.size(); i++) {
+            if (readers[i]) result.readers[fileNames[i]] = std::move(readers[i]);
+            else result.errors[fileNames[i]] = std::move(errors[i]);
         }
+
+        return result;
+    }
+
+    // Loads every file with the given extension found in a directory and its subdirectories
+    static K4IniBulkResult loadDirectory(const std::string& directory, const std::string& extension = ".ini",
+                                         const K4IniOptions& options = K4IniOptions(), unsigned nThreads = 0) {
+        return loadSelected(directory, [&](const std::filesystem::directory_entry& entry) { return entry.path().extension() == extension; }, options, nThreads);
+    }
+
+    // Loads every file matching a glob pattern found in a directory and its subdirectories
+    static K4IniBulkResult loadDirectory(const std::string& directory, const K4IniGlob& glob,
+                                         const K4IniOptions& options = K4IniOptions(), unsigned nThreads = 0) {
+        bool wholePath = glob.pattern.find('/') != std::string::npos;
+        return loadSelected(directory, [&](const std::filesystem::directory_entry& entry) {
+            if (!wholePath) return glob.matches(entry.path().filename().string());
+            return glob.matches(entry.path().lexically_relative(directory).generic_string());
+        }, options, nThreads);
+    }
+};
+// Reader with fixed capacities that never allocates, for threads that mustn't (real-time audio, control loops).
+// The sections, keys and the file content are kept inside the object, so it can be static or on the stack;
+// with MaxBytes = 0, the content is kept in a buffer given by the caller instead:
+//     static K4IniFixedReader<16, 256, 16 * 1024> settings;         // 16 sections, 256 keys, 16 KiB of content
+//     settings.loadFile("Audio.ini");
+//     int rate = settings.read<int>("Output", "rate", 48000);
+//     std::string_view device = settings.readView("Output", "device");
+// Comments, quoted values and the dialect's delimiter and whitespace are supported;
+// heredocs and continuation lines aren't, and UTF-16 files aren't converted.
+// Reading a std::string (or a list) allocates like any std::string: use readView for text.
+template<size_t MaxSections, size_t MaxKeys, size_t MaxBytes, typename Dialect = K4IniDialect>
+class K4IniFixedReader {
+private:
+    static_assert(MaxSections > 0 && MaxKeys > 0, "K4IniFixedReader needs room for at least one section and one key");
+    static_assert(MaxKeys < (1u << 31) && MaxSections < (1u << 31), "K4IniFixedReader indexes are 32-bit");
+    static_assert(!Dialect::collectDiagnostics && !Dialect::strict, "Diagnostics allocate: K4IniFixedReader doesn't support them");
+
+    struct SectionEntry {
+        std::string_view name;
+        uint64_t hash = 0;
+    };
+
+    struct KeyEntry {
+        std::string_view key;
+        std::string_view value;
+        uint64_t hash = 0; // Hash of the section and the key
+        uint32_t section = 0;
+    };
+
+    // Open-addressing table of key indexes (+1, 0 is an empty slot), at most half full
+    static constexpr size_t slotCount = [] {
+        size_t n = 1;
+        while (n < MaxKeys * 2) n <<= 1;
+        return n;
+    }();
+
+    std::array<char, MaxBytes> storage{}; // The content, when the caller doesn't provide a buffer
+    char* buffer = storage.data();
+    size_t capacity = MaxBytes;
+
+    std::array<SectionEntry, MaxSections> sections{};
+    std::array<KeyEntry, MaxKeys> keys{};
+    std::array<uint32_t, slotCount> slots{};
+    size_t nSections = 0;
+    size_t nKeys = 0;
+
+    // Returns the index of a section, adding it if it's new (npos if there's no room left)
+    size_t addSection(std::string_view name) noexcept {
+        uint64_t hash = K4IniKey::hashName(name);
+        for (size_t i = 0; i < nSections; i++)
+            if (sections[i].hash == hash && sections[i].name == name) return i;
+
+        if (nSections == MaxSections) return std::string_view::npos;
+        sections[nSections] = { name, hash };
+        return nSections++;
+    }
+
+    // Adds a key-value pair to a section; a key found again replaces its value
+    bool addKey(size_t section, std::string_view key, std::string_view value) noexcept {
+        uint64_t hash = K4IniReader::pairHash(sections[section].hash, K4IniKey::hashName(key));
+
+        for (size_t slot = hash & (slotCount - 1);; slot = (slot + 1) & (slotCount - 1)) {
+            if (slots[slot] == 0) {
+                if (nKeys == MaxKeys) return false;
+                keys[nKeys] = { key, value, hash, static_cast<uint32_t>(section) };
+                slots[slot] = static_cast<uint32_t>(++nKeys);
+                return true;
+            }
+
+            KeyEntry& entry = keys[slots[slot] - 1];
+            if (entry.hash == hash && entry.section == section && entry.key == key) {
+                entry.value = value;
+                return true;
+            }
+        }
+    }
+
+    // Replaces the escapes of a quoted value in place (the value only gets shorter).
+    // 'p' is just after the opening quote; returns false, without changing anything, if the quote isn't closed.
+    static bool unquote(char* p, const char* last, char quote, std::string_view& value) noexcept {
+        for (const char* q = p;; q += 2) { // Checks first that the quote is closed
+            q = K4IniReader::findQuoteOrEscape(q, last, quote);
+            if (q == last || (q + 1 == last && *q == '\\')) return false;
+            if (*q == quote) break;
+        }
+
+        char* first = p;
+        char* out = p;
+        for (;;) {
+            char* stop = const_cast<char*>(K4IniReader::findQuoteOrEscape(p, last, quote));
+            std::memmove(out, p, static_cast<size_t>(stop - p));
+            out += stop - p;
+            if (*stop == quote) break; // Anything after the closing quote is ignored
+
+            switch (stop[1]) {
+            case 'n': *out++ = '\n'; break;
+            case 't': *out++ = '\t'; break;
+            case 'r': *out++ = '\r'; break;
+            case '0': *out++ = '\0'; break;
+            default: *out++ = stop[1]; break; // \", \', \\ and any other escaped character
+            }
+            p = stop + 2;
+        }
+
+        value = std::string_view(first, static_cast<size_t>(out - first));
+        return true;
+    }
+
+    // Parses the content copied into the buffer, pointing the names and values into it
+    bool parse(size_t size) noexcept {
+        size_t currentSection = std::string_view::npos; // Keys found before any header belong to the unnamed section
+        size_t lineStart = (size >= 3 && std::memcmp(buffer, "\xEF\xBB\xBF", 3) == 0) ? 3 : 0; // Skips the UTF-8 byte order mark
+
+        while (lineStart < size) {
+            const char* newline = static_cast<const char*>(std::memchr(buffer + lineStart, '\n', size - lineStart));
+            size_t lineEnd = newline ? static_cast<size_t>(newline - buffer) : size;
+            char* lineData = buffer + lineStart;
+            std::string_view line(lineData, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            std::string_view name, value;
+            bool quoted = false;
+
+            if constexpr (Dialect::quotedValues) { // Same rules as K4IniReader::parseQuoted
+                size_t posDelimiter = line.find(Dialect::delimiter);
+                size_t posQuote = posDelimiter == std::string_view::npos ? posDelimiter : K4IniReader::skipSpaces<Dialect>(line, posDelimiter + 1);
+
+                if (posQuote != std::string_view::npos && (line[posQuote] == '"' || line[posQuote] == '\'')) {
+                    std::string_view key = line.substr(0, posDelimiter);
+                    if (key.find('[') == std::string_view::npos && K4IniReader::findComment<Dialect>(key) == std::string_view::npos &&
+                        unquote(lineData + posQuote + 1, lineData + line.size(), line[posQuote], value)) {
+                        name = K4IniReader::trimmed<Dialect>(key);
+                        quoted = true;
+                    }
+                }
+            }
+
+            if (!quoted) {
+                line = line.substr(0, K4IniReader::findComment<Dialect>(line));
+
+                size_t posBracketStart = line.find('[');
+                if constexpr (!Dialect::headerAnywhere) {
+                    if (posBracketStart != std::string_view::npos && K4IniReader::skipSpaces<Dialect>(line) != posBracketStart)
+                        posBracketStart = std::string_view::npos;
+                }
+                if (posBracketStart > line.find(Dialect::delimiter)) posBracketStart = std::string_view::npos; // Part of the value
+
+                if (posBracketStart != std::string_view::npos) {
+                    size_t posBracketEnd = line.find(']', posBracketStart);
+                    if (posBracketEnd == std::string_view::npos) continue;
+
+                    currentSection = addSection(K4IniReader::trimmed<Dialect>(line.substr(posBracketStart + 1, posBracketEnd - posBracketStart - 1)));
+                    if (currentSection == std::string_view::npos) return false;
+                    continue;
+                }
+
+                size_t posDelimiter = line.find(Dialect::delimiter);
+                if (posDelimiter == std::string_view::npos) continue;
+
+                name = K4IniReader::trimmed<Dialect>(line.substr(0, posDelimiter));
+                value = K4IniReader::trimmed<Dialect>(line.substr(posDelimiter + 1));
+            }
+
+            if (currentSection == std::string_view::npos) {
+                currentSection = addSection("");
+                if (currentSection == std::string_view::npos) return false;
+            }
+            if (!addKey(currentSection, name, value)) return false;
+        }
+
+        return true;
+    }
+
+    inline const std::string_view* find(const K4IniKey& section, const K4IniKey& key) const noexcept {
+        uint64_t hash = K4IniReader::pairHash(section.hash, key.hash);
+
+        for (size_t slot = hash & (slotCount - 1); slots[slot] != 0; slot = (slot + 1) & (slotCount - 1)) {
+            const KeyEntry& entry = keys[slots[slot] - 1];
+            if (entry.hash == hash && entry.key == key.name && sections[entry.section].name == section.name) return &entry.value;
+        }
+        return nullptr;
     }
 
-    // Reads a value of a key from a section
     template<typename T>
-    T read(const std::string& section, const std::string& key, T defaultValue, bool toLowerString = false) const noexcept {
-        std::string outValue;
-        if (!find(section, key, outValue)) return defaultValue;
+    static K4IniStatus convertTo(const std::string_view* text, T& out, bool toLowerString, bool exact = false) noexcept {
+        if (!text) return K4IniStatus::Missing;
 
-        if constexpr (std::is_same_v<T, bool>) // If T is a boolean
-            return (outValue == "true" || outValue == "1" || outValue == "on" || outValue == "yes");
+        K4IniReader::ValueRef value;
+        value.text = *text;
+        if constexpr (std::is_arithmetic_v<T>) K4IniReader::classify(*text, value); // Numbers and booleans are read like K4IniReader does
+        return K4IniReader::convertTo(&value, out, toLowerString, exact);
+    }
+
+public:
+    // Reader using its own storage for the content (MaxBytes bytes)
+    K4IniFixedReader() noexcept {
+        static_assert(MaxBytes > 0, "K4IniFixedReader<..., 0> keeps the content in a buffer given to its constructor");
+    }
 
-        else if constexpr (std::is_same_v<T, char>) // If T is a char or a wide one
-            return outValue.empty() ? defaultValue : outValue[0];
+    // Reader keeping the content in 'buffer', which must outlive it
+    K4IniFixedReader(char* buffer, size_t capacity) noexcept : buffer(buffer), capacity(capacity) {}
 
-        else if constexpr (std::is_arithmetic_v<T>) { // If T is an arithmetic type (numeric)
-            T outParsedValue = defaultValue;
+    // The names and values point into the buffer
+    K4IniFixedReader(const K4IniFixedReader&) = delete;
+    K4IniFixedReader& operator=(const K4IniFixedReader&) = delete;
 
-            // Tries converting the value read to a numeric type
-            auto result = std::from_chars(outValue.data(), outValue.data() + outValue.size(), outParsedValue);
+    // Removes all the sections and keys
+    void clear() noexcept {
+        nSections = nKeys = 0;
+        slots.fill(0);
+    }
+
+    // Copies the content of a .ini file into the buffer and parses it.
+    // Returns false, leaving the reader empty, if it exceeds the capacity in bytes, sections or keys.
+    bool load(std::string_view content) noexcept {
+        clear();
+        if (content.size() > capacity) return false;
 
-            // Returns the out value regardless of the conversion result;
-            // if it failed, it will not modify the out value,
-            // therefore the out value will still have the default one
-            return outParsedValue; 
+        std::memcpy(buffer, content.data(), content.size());
+        if (!parse(content.size())) {
+            clear();
+            return false;
         }
+        return true;
+    }
 
-        else if constexpr (std::is_same_v<T, std::string>) { // If T is a string
-            if (toLowerString) {
-                bool hasUpper = std::any_of(outValue.begin(), outValue.end(), [](unsigned char c) { return std::isupper(c); });
-                if (hasUpper)
-                    // Lowers the out value only if an upper character was found
-                    std::transform(outValue.begin(), outValue.end(), outValue.begin(), [](unsigned char c) { return std::tolower(c); });
+    // Reads a .ini file into the buffer and parses it (see load).
+    // Doesn't allocate on POSIX systems; elsewhere, opening the file may.
+    bool loadFile(const char* fileName) noexcept {
+        clear();
+        size_t size = 0;
+
+#ifdef K4INIREADER_POSIX
+        int fd = ::open(fileName, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        for (;;) {
+            if (size == capacity) { // Full: the file fits only if nothing is left to read
+                char extra;
+                ssize_t n = ::read(fd, &extra, 1);
+                if (n < 0 && errno == EINTR) continue;
+                if (n != 0) size = capacity + 1;
+                break;
             }
 
-            return outValue;
+            ssize_t n = ::read(fd, buffer + size, capacity - size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                if (n < 0) size = capacity + 1;
+                break;
+            }
+            size += static_cast<size_t>(n);
         }
+        ::close(fd);
+#else
+        std::FILE* file = std::fopen(fileName, "rb");
+        if (!file) return false;
 
-        // Fallback return for unhandled types
-        return defaultValue;
+        std::setvbuf(file, nullptr, _IONBF, 0);
+        size = std::fread(buffer, 1, capacity, file);
+        if (std::ferror(file) || (size == capacity && std::fgetc(file) != EOF)) size = capacity + 1;
+        std::fclose(file);
+#endif
+
+        if (size > capacity || !parse(size)) {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    inline size_t sectionCount() const noexcept { return nSections; }
+    inline size_t keyCount() const noexcept { return nKeys; }
+
+    // Reads a value as it's stored, without copying it; the view is valid until the next load
+    std::string_view readView(const K4IniKey& section, const K4IniKey& key, std::string_view defaultValue = {}) const noexcept {
+        const std::string_view* value = find(section, key);
+        return value ? *value : defaultValue;
+    }
+
+    std::string_view readView(std::string_view section, std::string_view key, std::string_view defaultValue = {}) const noexcept {
+        return readView(K4IniKey(section), K4IniKey(key), defaultValue);
+    }
+
+    // Reads and converts a value like K4IniReader::read
+    template<typename T>
+    T read(const K4IniKey& section, const K4IniKey& key, T defaultValue, bool toLowerString = false) const noexcept {
+        T out = std::move(defaultValue);
+        convertTo(find(section, key), out, toLowerString);
+        return out;
+    }
+
+    template<typename T>
+    T read(std::string_view section, std::string_view key, T defaultValue, bool toLowerString = false) const noexcept {
+        return read<T>(K4IniKey(section), K4IniKey(key), std::move(defaultValue), toLowerString);
+    }
+
+    template<typename T>
+    std::optional<T> tryRead(std::string_view section, std::string_view key, bool toLowerString = false) const noexcept {
+        T out{};
+        if (convertTo(find(K4IniKey(section), K4IniKey(key)), out, toLowerString, true) != K4IniStatus::Ok) return std::nullopt;
+        return out;
+    }
+
+    template<typename T>
+    K4IniResult<T> readResult(std::string_view section, std::string_view key, bool toLowerString = false) const noexcept {
+        K4IniResult<T> result;
+        result.status = convertTo(find(K4IniKey(section), K4IniKey(key)), result.value, toLowerString, true);
+        return result;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,79 @@
+/*
+ *  K4IniBloomBench - Measures reads of mostly missing keys, with and without the Bloom filter
+ *  Part of K4IniReader: https://github.com/Kevin4e/K4IniReader
+ *
+ *  Build: g++ -std=c++17 -O2 tools/K4IniBloomBench.cpp -o K4IniBloomBench
+ *  Usage: K4IniBloomBench [bitsPerKey]
+ *
+ *  The file has 200 sections of 12 keys; 100k reads are done, 90% of them for keys
+ *  missing from sections that exist. Prints the best time per read over a few rounds.
+ */
+
+#include "../K4IniReader.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+    constexpr int nSections = 200;
+    constexpr int nKeys = 12;
+    constexpr int nReads = 100000;
+    constexpr int missPercent = 90;
+    constexpr int nRounds = 5;
+
+    struct Lookup {
+        std::string section;
+        std::string key;
+    };
+
+    // Best time per read, in nanoseconds
+    double measure(const K4IniReader& reader, const std::vector<Lookup>& lookups, long long& found) {
+        double best = 1e300;
+
+        for (int round = 0; round < nRounds; round++) {
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& lookup : lookups) found += reader.read<int>(lookup.section, lookup.key, 0);
+            auto end = std::chrono::steady_clock::now();
+
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(lookups.size()));
+        }
+
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t bitsPerKey = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 10;
+
+    std::string content;
+    for (int s = 0; s < nSections; s++) {
+        content += "[section" + std::to_string(s) + "]\n";
+        for (int k = 0; k < nKeys; k++) content += "key" + std::to_string(k) + " = " + std::to_string(s * nKeys + k) + '\n';
+    }
+
+    std::mt19937 rng(42);
+    std::vector<Lookup> lookups(nReads);
+    for (auto& lookup : lookups) {
+        lookup.section = "section" + std::to_string(rng() % nSections);
+        bool miss = static_cast<int>(rng() % 100) < missPercent;
+        lookup.key = (miss ? "optional" : "key") + std::to_string(rng() % nKeys);
+    }
+
+    K4IniOptions filtered;
+    filtered.filterBitsPerKey = bitsPerKey;
+
+    K4IniReader plain = K4IniReader::fromString(content);
+    K4IniReader withFilter = K4IniReader::fromString(content, filtered);
+
+    long long found = 0; // Keeps the reads from being optimized away
+    double plainTime = measure(plain, lookups, found);
+    double filteredTime = measure(withFilter, lookups, found);
+
+    std::printf("%d sections x %d keys, %d reads, %d%% misses\n", nSections, nKeys, nReads, missPercent);
+    std::printf("Without filter:          %.1f ns/read\n", plainTime);
+    std::printf("With filter (%zu bits/key): %.1f ns/read\n", bitsPerKey, filteredTime);
+    std::printf("(checksum %lld)\n", found);
+    return 0;
+}
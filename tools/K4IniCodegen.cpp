@@ -0,0 +1,247 @@
+/*
+ *  K4IniCodegen - Generates a typed C++ accessor header from a sample .ini file
+ *  Part of K4IniReader: https://github.com/Kevin4e/K4IniReader
+ *
+ *  Build: g++ -std=c++17 -O2 tools/K4IniCodegen.cpp -o K4IniCodegen
+ *  Usage: K4IniCodegen <sample.ini> <StructName> [output.hpp]
+ *
+ *  Every section of the sample becomes a nested struct and every key a field,
+ *  typed after its sample value (which is also the field's default value).
+ *  The generated 'load' fills the struct from a K4IniReader in a single pass,
+ *  dispatching every (section, key) pair through a constexpr hash switch.
+ */
+
+#include "../K4IniReader.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace {
+    struct Field {
+        std::string key;   // Key in the .ini file
+        std::string name;  // Identifier of the field
+        std::string id;    // Enumerator of the field in 'Field'
+        std::string type;  // C++ type of the field
+        std::string value; // Default value, as a C++ literal
+    };
+
+    struct Section {
+        std::string name;     // Name in the .ini file
+        std::string field;    // Identifier of the struct member
+        std::string type;     // Identifier of the nested struct
+        std::map<std::string, Field> fields;
+    };
+
+    // Same hash as the one emitted in the generated header (FNV-1a over the section, a separator and the key)
+    uint64_t hashPair(std::string_view s, std::string_view k) {
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (unsigned char c : s) h = (h ^ c) * 0x100000001B3ull;
+        h = (h ^ 0xFF) * 0x100000001B3ull;
+        for (unsigned char c : k) h = (h ^ c) * 0x100000001B3ull;
+        return h;
+    }
+
+    // Turns a name into a valid identifier, unique among 'used'.
+    // With a 'suffix', the identifier followed by it must be unused too, and both are reserved.
+    std::string identifier(std::string_view name, std::set<std::string>& used, const char* fallback, std::string_view suffix = {}) {
+        static const std::set<std::string> keywords = { // C++20 keywords and alternative tokens
+            "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+            "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+            "constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+            "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+            "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+            "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+            "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+            "switch", "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename",
+            "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+        };
+
+        std::string id;
+        for (unsigned char c : name) id += std::isalnum(c) ? static_cast<char>(c) : '_';
+
+        if (id.empty()) id = fallback;
+        if (std::isdigit(static_cast<unsigned char>(id[0])) || keywords.count(id)) id = '_' + id;
+
+        std::string unique = id;
+        for (int i = 2; used.count(unique) || (!suffix.empty() && used.count(unique + std::string(suffix))); i++)
+            unique = id + '_' + std::to_string(i);
+
+        used.insert(unique);
+        if (!suffix.empty()) used.insert(unique + std::string(suffix));
+        return unique;
+    }
+
+    // Escapes a string for a C++ string literal
+    std::string quote(std::string_view s) {
+        std::string out = "\"";
+        for (unsigned char c : s) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            }
+            else if (c < 0x20 || c == 0x7F) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\%03o", c);
+                out += escaped;
+            }
+            else out += static_cast<char>(c);
+        }
+
+        return out + '"';
+    }
+
+    // Picks the type of a field after its sample value
+    void inferType(std::string_view value, Field& field) {
+        long long integer = 0;
+        auto intResult = std::from_chars(value.data(), value.data() + value.size(), integer);
+        if (!value.empty() && intResult.ec == std::errc() && intResult.ptr == value.data() + value.size()) {
+            bool fitsInt = integer >= std::numeric_limits<int>::min() && integer <= std::numeric_limits<int>::max();
+            field.type = fitsInt ? "int" : "long long";
+            field.value = std::to_string(integer) + (fitsInt ? "" : "LL");
+            return;
+        }
+
+        double floating = 0;
+        auto floatResult = std::from_chars(value.data(), value.data() + value.size(), floating);
+        if (!value.empty() && floatResult.ec == std::errc() && floatResult.ptr == value.data() + value.size() && std::isfinite(floating)) {
+            std::ostringstream literal;
+            literal.precision(17);
+            literal << floating;
+            field.type = "double";
+            field.value = literal.str();
+            if (field.value.find_first_of(".e") == std::string::npos) field.value += ".0";
+            return;
+        }
+
+        if (value == "true" || value == "false" || value == "on" || value == "off" || value == "yes" || value == "no") {
+            field.type = "bool";
+            field.value = K4IniReader::parse<bool>(value, false) ? "true" : "false";
+            return;
+        }
+
+        field.type = "std::string";
+        field.value = quote(value);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <sample.ini> <StructName> [output.hpp]\n";
+        return 1;
+    }
+
+    K4IniReader sample(argv[1]);
+    if (!sample.isOpen()) {
+        std::cerr << "Can't open " << argv[1] << '\n';
+        return 1;
+    }
+
+    // Collects the sections and keys, sorted so that the output doesn't depend on the hash map order
+    std::map<std::string, Section> sections;
+    sample.forEach([&](std::string_view section, std::string_view key, std::string_view value) {
+        Section& s = sections[std::string(section)];
+        s.name = section;
+
+        Field& f = s.fields[std::string(key)];
+        f.key = key;
+        inferType(value, f);
+    });
+
+    // The members generated in the struct, and the struct itself, can't be used by the sections
+    std::set<std::string> sectionIds = { argv[2], "hash", "field", "load", "Field" };
+    std::set<std::string> enumIds = { "None" };
+    std::map<uint64_t, std::string> hashes; // Checks that the hash is perfect over the known pairs
+    for (auto& [name, section] : sections) {
+        section.field = identifier(name, sectionIds, "global", "_t"); // Reserves the nested struct's name as well
+        section.type = section.field + "_t";
+
+        std::set<std::string> fieldIds = { section.type }; // A member can't be named after its struct
+        for (auto& [key, field] : section.fields) {
+            field.name = identifier(key, fieldIds, "value");
+            field.id = identifier(section.field + '_' + field.name, enumIds, "value");
+
+            auto [hashIt, inserted] = hashes.emplace(hashPair(name, key), name + "/" + key);
+            if (!inserted) {
+                std::cerr << "Hash collision between " << hashIt->second << " and " << name << '/' << key << '\n';
+                return 1;
+            }
+        }
+    }
+
+    std::ostringstream out;
+    out << "#pragma once\n\n"
+        << "// Generated by K4IniCodegen from " << argv[1] << ", do not edit\n\n"
+        << "#include \"K4IniReader.hpp\"\n\n"
+        << "#include <cstdint>\n#include <string>\n#include <string_view>\n\n"
+        << "struct " << argv[2] << " {\n";
+
+    for (const auto& [name, section] : sections) {
+        out << "    // [" << name << "]\n"
+            << "    struct " << section.type << " {\n";
+        for (const auto& [key, field] : section.fields)
+            out << "        " << field.type << ' ' << field.name << " = " << field.value << ";\n";
+        out << "    } " << section.field << ";\n\n";
+    }
+
+    out << "    enum class Field {\n        None,\n";
+    for (const auto& [name, section] : sections)
+        for (const auto& [key, field] : section.fields)
+            out << "        " << field.id << ",\n";
+    out << "    };\n\n";
+
+    out << "    // Hash of a (section, key) pair (FNV-1a)\n"
+        << "    static constexpr uint64_t hash(std::string_view section, std::string_view key) noexcept {\n"
+        << "        uint64_t h = 0xCBF29CE484222325ull;\n"
+        << "        for (char c : section) h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;\n"
+        << "        h = (h ^ 0xFF) * 0x100000001B3ull;\n"
+        << "        for (char c : key) h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;\n"
+        << "        return h;\n"
+        << "    }\n\n";
+
+    out << "    // Returns the field of a (section, key) pair; the hash is perfect over the known pairs\n"
+        << "    static constexpr Field field(std::string_view section, std::string_view key) noexcept {\n"
+        << "        switch (hash(section, key)) {\n";
+    for (const auto& [name, section] : sections)
+        for (const auto& [key, field] : section.fields) {
+            char hex[24];
+            std::snprintf(hex, sizeof(hex), "0x%016llXull", static_cast<unsigned long long>(hashPair(name, key)));
+            out << "        case " << hex << ": return (section == " << quote(name) << " && key == " << quote(key) << ") ? Field::"
+                << field.id << " : Field::None;\n";
+        }
+    out << "        default: return Field::None;\n"
+        << "        }\n"
+        << "    }\n\n";
+
+    out << "    // Fills the fields from a reader in a single pass; keys missing from the reader keep their current value\n"
+        << "    void load(const K4IniReader& reader) {\n"
+        << "        reader.forEach([this](std::string_view section, std::string_view key, std::string_view value) {\n"
+        << "            switch (field(section, key)) {\n";
+    for (const auto& [name, section] : sections)
+        for (const auto& [key, field] : section.fields) {
+            std::string member = section.field + '.' + field.name;
+            out << "            case Field::" << field.id << ": " << member
+                << " = K4IniReader::parse(value, " << member << "); break;\n";
+        }
+    out << "            default: break;\n"
+        << "            }\n"
+        << "        });\n"
+        << "    }\n"
+        << "};\n";
+
+    if (argc > 3) {
+        std::ofstream file(argv[3], std::ios::binary);
+        if (!(file << out.str())) {
+            std::cerr << "Can't write " << argv[3] << '\n';
+            return 1;
+        }
+    }
+    else std::cout << out.str();
+
+    return 0;
+}
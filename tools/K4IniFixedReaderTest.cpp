@@ -0,0 +1,94 @@
+/*
+ *  K4IniFixedReaderTest - Checks that K4IniFixedReader never allocates on the heap
+ *  Part of K4IniReader: https://github.com/Kevin4e/K4IniReader
+ *
+ *  Build: g++ -std=c++17 -O2 tools/K4IniFixedReaderTest.cpp -o K4IniFixedReaderTest
+ *  Usage: K4IniFixedReaderTest
+ *
+ *  'operator new' is replaced by a counting version; loading a file and reading it
+ *  with a K4IniFixedReader must not call it. Returns 0 if every check passes.
+ */
+
+#include "../K4IniReader.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    bool counting = false;     // Allocations are only counted while the reader is used
+    size_t allocationCount = 0;
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            failures++;
+        }
+    }
+
+    // Static storage, so that not even the reader itself is on the heap
+    K4IniFixedReader<8, 64, 4096> reader;
+}
+
+void* operator new(size_t size) {
+    if (counting) allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (counting) allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    const char* fileName = "K4IniFixedReaderTest.ini";
+
+    std::FILE* file = std::fopen(fileName, "wb");
+    if (!file) {
+        std::fprintf(stderr, "Can't write %s\n", fileName);
+        return 1;
+    }
+    std::fputs("[Output]\n"
+               "rate = 48000 ; Sample rate\n"
+               "gain = -3.5\n"
+               "mute = yes\n"
+               "device = \"hw:0,1 \\\"main\\\"\"\n"
+               "[Input]\n"
+               "channels = 2 // Stereo\n", file);
+    std::fclose(file);
+
+    counting = true;
+
+    bool loaded = reader.loadFile(fileName);
+    int rate = reader.read<int>("Output", "rate", 0);
+    double gain = reader.read<double>("Output", "gain", 0.0);
+    bool mute = reader.read<bool>("Output", "mute", false);
+    std::string_view device = reader.readView("Output", "device");
+    std::optional<int> channels = reader.tryRead<int>("Input", "channels");
+    std::optional<int> missing = reader.tryRead<int>("Input", "latency");
+
+    counting = false;
+    std::remove(fileName);
+
+    check(loaded, "loadFile");
+    check(rate == 48000, "read<int>");
+    check(gain == -3.5, "read<double>");
+    check(mute, "read<bool>");
+    check(device == "hw:0,1 \"main\"", "readView");
+    check(channels && *channels == 2, "tryRead");
+    check(!missing, "tryRead of a missing key");
+    check(allocationCount == 0, "no heap allocation");
+
+    if (allocationCount) std::fprintf(stderr, "%zu heap allocations\n", allocationCount);
+    if (!failures) std::printf("All checks passed\n");
+    return failures ? 1 : 0;
+}